@@ -25,15 +25,27 @@
 #include "rapidjson/writer.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <boost/json.hpp>
 #include <boost/json/basic_parser_impl.hpp>
 #include <chrono>
+#include <condition_variable>
 #include <cstdio>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <istream>
 #include <memory>
+#include <mutex>
+#include <span>
+#include <streambuf>
+#include <string_view>
+#include <thread>
 #include <vector>
 #include <memory_resource>
 #include "test_suite.hpp"
+#include "latency_recorder.hpp"
 
 /*  References
 
@@ -63,7 +75,7 @@ std::string load_file(const std::string &path)
 
 static void Boost_JSON_Default_Parse(benchmark::State &state, std::string_view s)
 {
-  for (auto _ : state) {
+  for (auto _ : LatencyRecorder{ state }) {
     boost::json::stream_parser p;
     boost::json::error_code ec;
     p.write(s.data(), s.size(), ec);
@@ -78,7 +90,7 @@ static void Boost_JSON_Default_Parse(benchmark::State &state, std::string_view s
 
 static void Boost_JSON_PMR_Monotonic_Winkout_Parse(benchmark::State &state, std::string_view s)
 {
-  for (auto _ : state) {
+  for (auto _ : LatencyRecorder{ state }) {
     std::pmr::monotonic_buffer_resource mr;
     std::pmr::polymorphic_allocator<> pa{ &mr };
     auto &p = *pa.new_object<boost::json::stream_parser>();
@@ -107,7 +119,7 @@ static void Boost_JSON_PMR_Monotonic_Winkout_Parse(benchmark::State &state, std:
 
 static void Boost_JSON_PMR_Monotonic_Parse(benchmark::State &state, std::string_view s)
 {
-  for (auto _ : state) {
+  for (auto _ : LatencyRecorder{ state }) {
     boost::json::stream_parser p;
     std::pmr::monotonic_buffer_resource mr;
     std::pmr::polymorphic_allocator<> pa{ &mr };
@@ -130,7 +142,7 @@ static void Boost_JSON_PMR_Pool_Monotonic_Parse(benchmark::State &state, std::st
   std::pmr::unsynchronized_pool_resource mr{&upstream};
   std::pmr::polymorphic_allocator<> pa{ &mr };
 
-  for (auto _ : state) {
+  for (auto _ : LatencyRecorder{ state }) {
     boost::json::stream_parser p;
     boost::json::error_code ec;
     p.reset(pa); // it seems this reset is necessary, if you pass it to the
@@ -215,7 +227,7 @@ struct RapidJSONPMRAlloc
 
 static void RapidJSON_PMR_Parse(benchmark::State &state, std::string_view s)
 {
-  for (auto _ : state) {
+  for (auto _ : LatencyRecorder{ state }) {
     using namespace rapidjson;
     RapidJSONPMRAlloc alloc;
     GenericDocument<UTF8<>, RapidJSONPMRAlloc> d(&alloc);
@@ -225,7 +237,7 @@ static void RapidJSON_PMR_Parse(benchmark::State &state, std::string_view s)
 
 static void RapidJSON_PMR_Monotonic_Parse(benchmark::State &state, std::string_view s)
 {
-  for (auto _ : state) {
+  for (auto _ : LatencyRecorder{ state }) {
     using namespace rapidjson;
     std::pmr::monotonic_buffer_resource mr;
     RapidJSONPMRAlloc alloc{&mr};
@@ -236,7 +248,7 @@ static void RapidJSON_PMR_Monotonic_Parse(benchmark::State &state, std::string_v
 
 static void RapidJSON_PMR_Pool_Monotonic_Parse(benchmark::State &state, std::string_view s)
 {
-  for (auto _ : state) {
+  for (auto _ : LatencyRecorder{ state }) {
     using namespace rapidjson;
     std::pmr::monotonic_buffer_resource upstream{1000000};
     std::pmr::unsynchronized_pool_resource mr{&upstream};
@@ -249,7 +261,7 @@ static void RapidJSON_PMR_Pool_Monotonic_Parse(benchmark::State &state, std::str
 
 static void RapidJSON_PMR_Monotonic_Winkout_Parse(benchmark::State &state, std::string_view s)
 {
-  for (auto _ : state) {
+  for (auto _ : LatencyRecorder{ state }) {
     using namespace rapidjson;
     std::pmr::monotonic_buffer_resource mr;
     RapidJSONPMRAlloc alloc{&mr};
@@ -262,7 +274,7 @@ static void RapidJSON_PMR_Monotonic_Winkout_Parse(benchmark::State &state, std::
 
 static void RapidJSON_Monotonic_Parse(benchmark::State &state, std::string_view s)
 {
-  for (auto _ : state) {
+  for (auto _ : LatencyRecorder{ state }) {
     using namespace rapidjson;
     std::string monotonic_buffer{s};
     rapidjson::Document d;
@@ -272,7 +284,7 @@ static void RapidJSON_Monotonic_Parse(benchmark::State &state, std::string_view
 
 static void RapidJSON_CRT_Parse(benchmark::State &state, std::string_view s)
 {
-  for (auto _ : state) {
+  for (auto _ : LatencyRecorder{ state }) {
     using namespace rapidjson;
     CrtAllocator alloc;
     GenericDocument<UTF8<>, CrtAllocator> d(&alloc);
@@ -282,7 +294,7 @@ static void RapidJSON_CRT_Parse(benchmark::State &state, std::string_view s)
 
 static void RapidJSON_Default_Parse(benchmark::State &state, std::string_view s)
 {
-  for (auto _ : state) {
+  for (auto _ : LatencyRecorder{ state }) {
     rapidjson::Document d;
     d.Parse(s.data(), s.size());
   }
@@ -290,7 +302,7 @@ static void RapidJSON_Default_Parse(benchmark::State &state, std::string_view s)
 
 static void nlohmann_JSON_Default(benchmark::State &state, std::string_view s)
 {
-  for (auto _ : state) {
+  for (auto _ : LatencyRecorder{ state }) {
     auto jv = nlohmann::json::parse(s.begin(), s.end());
   }
 }
@@ -340,8 +352,828 @@ ADD_BENCHMARK(RapidJSON_Monotonic_Parse, "github_events.json");
 ADD_BENCHMARK(nlohmann_JSON_Default, "github_events.json");
 
 
+// NDJSON (newline delimited JSON) support. There is no NDJSON file in data/, so the corpus is
+// generated by re-serializing each element of an array from one of the existing documents
+// onto its own line.
+std::string make_ndjson(const std::string &path, std::string_view array_key)
+{
+  const auto jv = boost::json::parse(load_file(path));
+  const auto &records = array_key.empty() ? jv.as_array() : jv.as_object().at(array_key).as_array();
+
+  std::string result;
+  for (const auto &record : records) {
+    result += boost::json::serialize(record);
+    result += '\n';
+  }
+  return result;
+}
+
+// split the buffer into roughly num_chunks pieces, each of which ends on a line boundary
+std::vector<std::string_view> split_ndjson(std::string_view buffer, const std::size_t num_chunks)
+{
+  const auto target_size = std::max<std::size_t>(1, buffer.size() / std::max<std::size_t>(1, num_chunks));
+
+  std::vector<std::string_view> chunks;
+  while (!buffer.empty()) {
+    const auto newline = buffer.find('\n', std::min(target_size, buffer.size()) - 1);
+    const auto length = newline == std::string_view::npos ? buffer.size() : newline + 1;
+    chunks.push_back(buffer.substr(0, length));
+    buffer.remove_prefix(length);
+  }
+  return chunks;
+}
 
+template<typename Func> void for_each_line(std::string_view chunk, Func &&func)
+{
+  while (!chunk.empty()) {
+    const auto newline = chunk.find('\n');
+    const auto line = chunk.substr(0, newline);
+    if (!line.empty()) {
+      func(line);
+    }
+    chunk.remove_prefix(newline == std::string_view::npos ? chunk.size() : newline + 1);
+  }
+}
 
+// A fixed set of threads, each of which owns a monotonic_buffer_resource. Chunks are handed
+// out by an atomic counter so that a worker that finishes early picks up the slack.
+//
+// Each worker release()s its arena at the start of every run(), so anything allocated
+// during the previous run must be destroyed before run() is called again.
+class NDJSONWorkerPool
+{
+public:
+  using Job = std::function<void(std::size_t chunk_index, std::pmr::memory_resource &mr)>;
 
+  explicit NDJSONWorkerPool(const std::size_t num_threads)
+  {
+    for (std::size_t i = 0; i < num_threads; ++i) {
+      threads.emplace_back([this] { worker(); });
+    }
+  }
+
+  NDJSONWorkerPool(const NDJSONWorkerPool &) = delete;
+  NDJSONWorkerPool &operator=(const NDJSONWorkerPool &) = delete;
+
+  ~NDJSONWorkerPool()
+  {
+    {
+      std::scoped_lock lock{ mutex };
+      stopping = true;
+    }
+    work_available.notify_all();
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  }
+
+  // blocks until every chunk has been processed
+  void run(const std::size_t num_chunks, Job job)
+  {
+    std::unique_lock lock{ mutex };
+    current_job = std::move(job);
+    total_chunks = num_chunks;
+    next_chunk = 0;
+    busy_workers = threads.size();
+    ++generation;
+    work_available.notify_all();
+    work_done.wait(lock, [this] { return busy_workers == 0; });
+  }
+
+private:
+  void worker()
+  {
+    std::pmr::monotonic_buffer_resource mr;
+    std::size_t seen_generation = 0;
+
+    while (true) {
+      {
+        std::unique_lock lock{ mutex };
+        work_available.wait(lock, [&] { return stopping || generation != seen_generation; });
+        if (stopping) {
+          return;
+        }
+        seen_generation = generation;
+      }
+
+      mr.release();
+      for (auto chunk = next_chunk++; chunk < total_chunks; chunk = next_chunk++) {
+        current_job(chunk, mr);
+      }
+
+      std::scoped_lock lock{ mutex };
+      if (--busy_workers == 0) {
+        work_done.notify_one();
+      }
+    }
+  }
 
+  std::mutex mutex;
+  std::condition_variable work_available;
+  std::condition_variable work_done;
+  Job current_job;
+  std::size_t total_chunks = 0;
+  std::atomic<std::size_t> next_chunk = 0;
+  std::size_t busy_workers = 0;
+  std::size_t generation = 0;
+  bool stopping = false;
+  std::vector<std::thread> threads;
+};
+
+// more chunks than threads so that the atomic counter can balance uneven lines
+constexpr std::size_t ndjson_chunks_per_thread = 8;
+
+static void Boost_JSON_NDJSON_PMR_Monotonic_Parallel_Parse(benchmark::State &state, std::string_view s)
+{
+  const auto num_threads = static_cast<std::size_t>(state.range(0));
+  const auto chunks = split_ndjson(s, num_threads * ndjson_chunks_per_thread);
+
+  NDJSONWorkerPool pool{ num_threads };
+  // one slot per chunk, so that the documents can be consumed in input order no matter
+  // which worker parsed them
+  std::vector<std::vector<boost::json::value>> results(chunks.size());
+
+  std::size_t documents = 0;
+  for (auto _ : LatencyRecorder{ state }) {
+    // values live in the workers' arenas, get rid of them before the arenas are released
+    for (auto &result : results) {
+      result.clear();
+    }
+
+    pool.run(chunks.size(), [&](const std::size_t index, std::pmr::memory_resource &mr) {
+      std::pmr::polymorphic_allocator<> pa{ &mr };
+      boost::json::stream_parser p;
+      for_each_line(chunks[index], [&](const std::string_view line) {
+        boost::json::error_code ec;
+        p.reset(pa);
+        p.write(line.data(), line.size(), ec);
+        if (!ec)
+          p.finish(ec);
+        if (!ec)
+          results[index].push_back(p.release());
+      });
+    });
+
+    for (const auto &result : results) {
+      for (const auto &jv : result) {
+        benchmark::DoNotOptimize(jv);
+        ++documents;
+      }
+    }
+  }
+
+  state.counters["documents"] = benchmark::Counter(static_cast<double>(documents), benchmark::Counter::kIsRate);
+}
+
+static void NDJSON_Perf(benchmark::State &state, void (*test)(benchmark::State &, const std::string_view), const std::string &filename, const std::string &array_key)
+{
+  const auto s = make_ndjson(filename, array_key);
+  test(state, s);
+  state.SetBytesProcessed(static_cast<long long int>(state.iterations() * s.size()));
+}
+
+// runs from 1 thread up to the hardware thread count, wall clock time is what matters here
+#define ADD_NDJSON_BENCHMARK(func, filename, array_key)                    \
+  BENCHMARK_CAPTURE(NDJSON_Perf, func-filename, func, filename, array_key) \
+    ->DenseRange(1, static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))) \
+    ->UseRealTime()
+ADD_NDJSON_BENCHMARK(Boost_JSON_NDJSON_PMR_Monotonic_Parallel_Parse, "twitter.json", "statuses");
+ADD_NDJSON_BENCHMARK(Boost_JSON_NDJSON_PMR_Monotonic_Parallel_Parse, "github_events.json", "");
+
+
+// Chunked feeding. In production documents show up a few KiB at a time from socket reads
+// rather than as one contiguous buffer, so these hand each parser the input in chunk_size
+// pieces, copied into a fixed receive buffer the same way a recv() would.
+class ChunkedSource
+{
+public:
+  ChunkedSource(std::string_view data, const std::size_t chunk_size)
+    : remaining{ data }, buffer(chunk_size)
+  {
+  }
+
+  [[nodiscard]] bool empty() const noexcept { return remaining.empty(); }
+
+  // the returned span is only valid until the next call
+  std::span<char> next()
+  {
+    const auto length = std::min(buffer.size(), remaining.size());
+    std::memcpy(buffer.data(), remaining.data(), length);
+    remaining.remove_prefix(length);
+    return { buffer.data(), length };
+  }
+
+private:
+  std::string_view remaining;
+  std::vector<char> buffer;
+};
+
+// forwards to upstream and keeps track of the high water mark
+class PeakTrackingResource : public std::pmr::memory_resource
+{
+public:
+  explicit PeakTrackingResource(std::pmr::memory_resource *upstream_ = std::pmr::get_default_resource())
+    : upstream{ upstream_ }
+  {
+  }
+
+  [[nodiscard]] std::size_t peak() const noexcept { return peak_bytes; }
+
+private:
+  void *do_allocate(const std::size_t bytes, const std::size_t alignment) override
+  {
+    auto *ptr = upstream->allocate(bytes, alignment);
+    current_bytes += bytes;
+    peak_bytes = std::max(peak_bytes, current_bytes);
+    return ptr;
+  }
+
+  void do_deallocate(void *ptr, const std::size_t bytes, const std::size_t alignment) override
+  {
+    upstream->deallocate(ptr, bytes, alignment);
+    current_bytes -= bytes;
+  }
+
+  [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+  {
+    return this == &other;
+  }
+
+  std::pmr::memory_resource *upstream;
+  std::size_t current_bytes = 0;
+  std::size_t peak_bytes = 0;
+};
+
+// RapidJSON pulls characters from a stream, so refill from the source whenever the
+// current chunk runs dry
+class RapidJSONChunkedStream
+{
+public:
+  using Ch = char;
+
+  explicit RapidJSONChunkedStream(ChunkedSource &source_) : source{ &source_ } { refill(); }
+
+  [[nodiscard]] Ch Peek() const { return current.empty() ? '\0' : current.front(); }
+
+  Ch Take()
+  {
+    if (current.empty()) {
+      return '\0';
+    }
+    const auto c = current.front();
+    current = current.subspan(1);
+    ++consumed;
+    if (current.empty()) {
+      refill();
+    }
+    return c;
+  }
+
+  [[nodiscard]] std::size_t Tell() const { return consumed; }
+
+  // read only stream
+  Ch *PutBegin()
+  {
+    RAPIDJSON_ASSERT(false);
+    return nullptr;
+  }
+  void Put(Ch) { RAPIDJSON_ASSERT(false); }
+  void Flush() { RAPIDJSON_ASSERT(false); }
+  std::size_t PutEnd(Ch *)
+  {
+    RAPIDJSON_ASSERT(false);
+    return 0;
+  }
+
+private:
+  void refill()
+  {
+    if (!source->empty()) {
+      current = source->next();
+    }
+  }
+
+  ChunkedSource *source;
+  std::span<char> current;
+  std::size_t consumed = 0;
+};
+
+// nlohmann reads from a std::istream, which in turn pulls one chunk per underflow
+class ChunkedStreamBuf : public std::streambuf
+{
+public:
+  explicit ChunkedStreamBuf(ChunkedSource &source_) : source{ &source_ } {}
+
+protected:
+  int_type underflow() override
+  {
+    if (gptr() < egptr()) {
+      return traits_type::to_int_type(*gptr());
+    }
+    if (source->empty()) {
+      return traits_type::eof();
+    }
+    const auto chunk = source->next();
+    setg(chunk.data(), chunk.data(), chunk.data() + chunk.size());
+    return traits_type::to_int_type(*gptr());
+  }
+
+private:
+  ChunkedSource *source;
+};
+
+// the cheapest possible consumers, so that the SAX benchmarks measure the parser
+struct RapidJSONCountingHandler : rapidjson::BaseReaderHandler<rapidjson::UTF8<>, RapidJSONCountingHandler>
+{
+  std::size_t events = 0;
+  bool Default()
+  {
+    ++events;
+    return true;
+  }
+};
+
+struct NlohmannCountingSax
+{
+  std::size_t events = 0;
+
+  bool null() { return count(); }
+  bool boolean(bool) { return count(); }
+  bool number_integer(nlohmann::json::number_integer_t) { return count(); }
+  bool number_unsigned(nlohmann::json::number_unsigned_t) { return count(); }
+  bool number_float(nlohmann::json::number_float_t, const nlohmann::json::string_t &) { return count(); }
+  bool string(nlohmann::json::string_t &) { return count(); }
+  bool binary(nlohmann::json::binary_t &) { return count(); }
+  bool start_object(std::size_t) { return count(); }
+  bool key(nlohmann::json::string_t &) { return count(); }
+  bool end_object() { return count(); }
+  bool start_array(std::size_t) { return count(); }
+  bool end_array() { return count(); }
+  bool parse_error(std::size_t, const std::string &, const nlohmann::json::exception &) { return false; }
+
+private:
+  bool count()
+  {
+    ++events;
+    return true;
+  }
+};
+
+static void Boost_JSON_PMR_Monotonic_Chunked_Parse(benchmark::State &state, std::string_view s)
+{
+  const auto chunk_size = static_cast<std::size_t>(state.range(0));
+  std::size_t peak = 0;
+
+  for (auto _ : LatencyRecorder{ state }) {
+    PeakTrackingResource tracker;
+    {
+      std::pmr::monotonic_buffer_resource mr{ &tracker };
+      std::pmr::polymorphic_allocator<> pa{ &mr };
+      ChunkedSource source{ s, chunk_size };
+
+      // the parser's own buffer, which holds the strings and keys that straddle two chunks,
+      // comes from the tracker as well, the values from the monotonic resource over it
+      boost::json::stream_parser p{ &tracker };
+      boost::json::error_code ec;
+      p.reset(pa);
+      while (!ec && !source.empty()) {
+        const auto chunk = source.next();
+        p.write(chunk.data(), chunk.size(), ec);
+      }
+      if (!ec)
+        p.finish(ec);
+      if (!ec)
+        auto jv = p.release();
+    }
+    peak = std::max(peak, tracker.peak());
+  }
+
+  // a monotonic resource frees nothing before it goes, so for the values this is all they
+  // ever allocated, only the parser's buffer is ever given back
+  state.counters["peak_bytes"] = static_cast<double>(peak);
+}
+
+static void RapidJSON_PMR_Monotonic_Chunked_Parse(benchmark::State &state, std::string_view s)
+{
+  const auto chunk_size = static_cast<std::size_t>(state.range(0));
+  std::size_t peak = 0;
+
+  for (auto _ : LatencyRecorder{ state }) {
+    using namespace rapidjson;
+    PeakTrackingResource tracker;
+    {
+      std::pmr::monotonic_buffer_resource mr{ &tracker };
+      RapidJSONPMRAlloc alloc{ &mr };
+      ChunkedSource source{ s, chunk_size };
+      RapidJSONChunkedStream stream{ source };
+      GenericDocument<UTF8<>, RapidJSONPMRAlloc> d(&alloc);
+      d.ParseStream(stream);
+    }
+    peak = std::max(peak, tracker.peak());
+  }
 
+  state.counters["peak_bytes"] = static_cast<double>(peak);
+}
+
+static void RapidJSON_Chunked_SAX_Parse(benchmark::State &state, std::string_view s)
+{
+  const auto chunk_size = static_cast<std::size_t>(state.range(0));
+
+  for (auto _ : LatencyRecorder{ state }) {
+    ChunkedSource source{ s, chunk_size };
+    RapidJSONChunkedStream stream{ source };
+    RapidJSONCountingHandler handler;
+    rapidjson::Reader reader;
+    reader.Parse(stream, handler);
+    benchmark::DoNotOptimize(handler.events);
+  }
+}
+
+static void nlohmann_JSON_Chunked_Parse(benchmark::State &state, std::string_view s)
+{
+  const auto chunk_size = static_cast<std::size_t>(state.range(0));
+
+  for (auto _ : LatencyRecorder{ state }) {
+    ChunkedSource source{ s, chunk_size };
+    ChunkedStreamBuf buf{ source };
+    std::istream stream{ &buf };
+    auto jv = nlohmann::json::parse(stream);
+  }
+}
+
+static void nlohmann_JSON_Chunked_SAX_Parse(benchmark::State &state, std::string_view s)
+{
+  const auto chunk_size = static_cast<std::size_t>(state.range(0));
+
+  for (auto _ : LatencyRecorder{ state }) {
+    ChunkedSource source{ s, chunk_size };
+    ChunkedStreamBuf buf{ source };
+    std::istream stream{ &buf };
+    NlohmannCountingSax sax;
+    nlohmann::json::sax_parse(stream, &sax);
+    benchmark::DoNotOptimize(sax.events);
+  }
+}
+
+// 4 KiB to 64 KiB socket reads
+#define ADD_CHUNKED_BENCHMARK(func, filename) \
+  BENCHMARK_CAPTURE(JSON_Perf, func-filename, func, filename)->RangeMultiplier(2)->Range(4 << 10, 64 << 10)
+ADD_CHUNKED_BENCHMARK(Boost_JSON_PMR_Monotonic_Chunked_Parse, "citm_catalog.json");
+ADD_CHUNKED_BENCHMARK(RapidJSON_PMR_Monotonic_Chunked_Parse, "citm_catalog.json");
+ADD_CHUNKED_BENCHMARK(RapidJSON_Chunked_SAX_Parse, "citm_catalog.json");
+ADD_CHUNKED_BENCHMARK(nlohmann_JSON_Chunked_Parse, "citm_catalog.json");
+ADD_CHUNKED_BENCHMARK(nlohmann_JSON_Chunked_SAX_Parse, "citm_catalog.json");
+
+ADD_CHUNKED_BENCHMARK(Boost_JSON_PMR_Monotonic_Chunked_Parse, "twitter.json");
+ADD_CHUNKED_BENCHMARK(RapidJSON_PMR_Monotonic_Chunked_Parse, "twitter.json");
+ADD_CHUNKED_BENCHMARK(RapidJSON_Chunked_SAX_Parse, "twitter.json");
+ADD_CHUNKED_BENCHMARK(nlohmann_JSON_Chunked_Parse, "twitter.json");
+ADD_CHUNKED_BENCHMARK(nlohmann_JSON_Chunked_SAX_Parse, "twitter.json");
+
+
+// Serialization. Each document is parsed once up front and then written out every
+// iteration, so the numbers are directly comparable with the parse benchmarks on the same
+// files. Each benchmark returns the number of bytes written per iteration, which is what
+// the reported throughput is based on.
+
+// writes into a buffer that has been preallocated to the size of the whole document
+struct RapidJSONFixedBufferStream
+{
+  using Ch = char;
+
+  std::span<char> buffer;
+  std::size_t written = 0;
+
+  void Put(const Ch c)
+  {
+    if (written < buffer.size()) {
+      buffer[written++] = c;
+    }
+  }
+  void Flush() {}
+};
+
+class NlohmannFixedBufferAdapter : public nlohmann::detail::output_adapter_protocol<char>
+{
+public:
+  explicit NlohmannFixedBufferAdapter(std::span<char> buffer_) : buffer{ buffer_ } {}
+
+  void write_character(const char c) override
+  {
+    if (written < buffer.size()) {
+      buffer[written++] = c;
+    }
+  }
+
+  void write_characters(const char *s, const std::size_t length) override
+  {
+    const auto to_copy = std::min(length, buffer.size() - written);
+    std::memcpy(buffer.data() + written, s, to_copy);
+    written += to_copy;
+  }
+
+  void reset() noexcept { written = 0; }
+  [[nodiscard]] std::size_t size() const noexcept { return written; }
+
+private:
+  std::span<char> buffer;
+  std::size_t written = 0;
+};
+
+static std::size_t Boost_JSON_Default_Serialize(benchmark::State &state, std::string_view s)
+{
+  const auto jv = boost::json::parse(s);
+  std::size_t written = 0;
+  for (auto _ : LatencyRecorder{ state }) {
+    const auto out = boost::json::serialize(jv);
+    written = out.size();
+    benchmark::DoNotOptimize(out.data());
+  }
+  return written;
+}
+
+static std::size_t Boost_JSON_PMR_Monotonic_Serialize(benchmark::State &state, std::string_view s)
+{
+  const auto jv = boost::json::parse(s);
+
+  // the string keeps its capacity across iterations, so once it has grown to the size of
+  // the document nothing else is ever asked of the monotonic resource
+  std::pmr::monotonic_buffer_resource mr;
+  std::pmr::string out{ &mr };
+  boost::json::serializer sr;
+  std::array<char, 4096> chunk{};
+
+  for (auto _ : LatencyRecorder{ state }) {
+    out.clear();
+    sr.reset(&jv);
+    while (!sr.done()) {
+      out += sr.read(chunk.data(), chunk.size());
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  return out.size();
+}
+
+static std::size_t Boost_JSON_Fixed_Buffer_Serialize(benchmark::State &state, std::string_view s)
+{
+  const auto jv = boost::json::parse(s);
+  std::vector<char> buffer(boost::json::serialize(jv).size());
+  boost::json::serializer sr;
+
+  std::size_t written = 0;
+  for (auto _ : LatencyRecorder{ state }) {
+    written = 0;
+    sr.reset(&jv);
+    while (!sr.done() && written < buffer.size()) {
+      written += sr.read(buffer.data() + written, buffer.size() - written).size();
+    }
+    benchmark::DoNotOptimize(buffer.data());
+  }
+  return written;
+}
+
+static std::size_t RapidJSON_Default_Serialize(benchmark::State &state, std::string_view s)
+{
+  rapidjson::Document d;
+  d.Parse(s.data(), s.size());
+
+  std::size_t written = 0;
+  for (auto _ : LatencyRecorder{ state }) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    d.Accept(writer);
+    written = buffer.GetSize();
+    benchmark::DoNotOptimize(buffer.GetString());
+  }
+  return written;
+}
+
+static std::size_t RapidJSON_PMR_Monotonic_Serialize(benchmark::State &state, std::string_view s)
+{
+  using namespace rapidjson;
+  Document d;
+  d.Parse(s.data(), s.size());
+
+  // both the output buffer and the writer's stack come from the arena and are reused
+  std::pmr::monotonic_buffer_resource mr;
+  RapidJSONPMRAlloc alloc{ &mr };
+  using PMRStringBuffer = GenericStringBuffer<UTF8<>, RapidJSONPMRAlloc>;
+  PMRStringBuffer buffer(&alloc);
+  Writer<PMRStringBuffer, UTF8<>, UTF8<>, RapidJSONPMRAlloc> writer(buffer, &alloc);
+
+  for (auto _ : LatencyRecorder{ state }) {
+    buffer.Clear();
+    writer.Reset(buffer);
+    d.Accept(writer);
+    benchmark::DoNotOptimize(buffer.GetString());
+  }
+  return buffer.GetSize();
+}
+
+static std::size_t RapidJSON_Fixed_Buffer_Serialize(benchmark::State &state, std::string_view s)
+{
+  rapidjson::Document d;
+  d.Parse(s.data(), s.size());
+
+  const auto size = [&] {
+    rapidjson::StringBuffer sizing;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(sizing);
+    d.Accept(writer);
+    return sizing.GetSize();
+  }();
+
+  std::vector<char> buffer(size);
+  RapidJSONFixedBufferStream stream{ buffer };
+  rapidjson::Writer<RapidJSONFixedBufferStream> writer(stream);
+
+  for (auto _ : LatencyRecorder{ state }) {
+    stream.written = 0;
+    writer.Reset(stream);
+    d.Accept(writer);
+    benchmark::DoNotOptimize(buffer.data());
+  }
+  return stream.written;
+}
+
+static std::size_t nlohmann_JSON_Default_Dump(benchmark::State &state, std::string_view s)
+{
+  const auto jv = nlohmann::json::parse(s.begin(), s.end());
+
+  std::size_t written = 0;
+  for (auto _ : LatencyRecorder{ state }) {
+    const auto out = jv.dump();
+    written = out.size();
+    benchmark::DoNotOptimize(out.data());
+  }
+  return written;
+}
+
+// dump() always returns a std::string, so go through the serializer it uses internally to
+// be able to pick the output
+static std::size_t nlohmann_JSON_PMR_Monotonic_Dump(benchmark::State &state, std::string_view s)
+{
+  const auto jv = nlohmann::json::parse(s.begin(), s.end());
+
+  std::pmr::monotonic_buffer_resource mr;
+  std::pmr::string out{ &mr };
+  nlohmann::detail::serializer<nlohmann::json> serializer{ nlohmann::detail::output_adapter<char, std::pmr::string>(out), ' ' };
+
+  for (auto _ : LatencyRecorder{ state }) {
+    out.clear();
+    serializer.dump(jv, false, false, 0);
+    benchmark::DoNotOptimize(out.data());
+  }
+  return out.size();
+}
+
+static std::size_t nlohmann_JSON_Fixed_Buffer_Dump(benchmark::State &state, std::string_view s)
+{
+  const auto jv = nlohmann::json::parse(s.begin(), s.end());
+
+  std::vector<char> buffer(jv.dump().size());
+  const auto adapter = std::make_shared<NlohmannFixedBufferAdapter>(buffer);
+  nlohmann::detail::serializer<nlohmann::json> serializer{ adapter, ' ' };
+
+  for (auto _ : LatencyRecorder{ state }) {
+    adapter->reset();
+    serializer.dump(jv, false, false, 0);
+    benchmark::DoNotOptimize(buffer.data());
+  }
+  return adapter->size();
+}
+
+static void JSON_Serialize_Perf(benchmark::State &state, std::size_t (*test)(benchmark::State &, const std::string_view), const std::string &filename)
+{
+  auto s = load_file(filename);
+  const auto output_size = test(state, s);
+  state.SetBytesProcessed(static_cast<long long int>(state.iterations() * output_size));
+}
+
+#define ADD_SERIALIZE_BENCHMARK(func, filename) BENCHMARK_CAPTURE(JSON_Serialize_Perf, func-filename, func, filename)
+ADD_SERIALIZE_BENCHMARK(Boost_JSON_Default_Serialize, "citm_catalog.json");
+ADD_SERIALIZE_BENCHMARK(Boost_JSON_PMR_Monotonic_Serialize, "citm_catalog.json");
+ADD_SERIALIZE_BENCHMARK(Boost_JSON_Fixed_Buffer_Serialize, "citm_catalog.json");
+ADD_SERIALIZE_BENCHMARK(RapidJSON_Default_Serialize, "citm_catalog.json");
+ADD_SERIALIZE_BENCHMARK(RapidJSON_PMR_Monotonic_Serialize, "citm_catalog.json");
+ADD_SERIALIZE_BENCHMARK(RapidJSON_Fixed_Buffer_Serialize, "citm_catalog.json");
+ADD_SERIALIZE_BENCHMARK(nlohmann_JSON_Default_Dump, "citm_catalog.json");
+ADD_SERIALIZE_BENCHMARK(nlohmann_JSON_PMR_Monotonic_Dump, "citm_catalog.json");
+ADD_SERIALIZE_BENCHMARK(nlohmann_JSON_Fixed_Buffer_Dump, "citm_catalog.json");
+
+ADD_SERIALIZE_BENCHMARK(Boost_JSON_Default_Serialize, "gsoc-2018.json");
+ADD_SERIALIZE_BENCHMARK(Boost_JSON_PMR_Monotonic_Serialize, "gsoc-2018.json");
+ADD_SERIALIZE_BENCHMARK(Boost_JSON_Fixed_Buffer_Serialize, "gsoc-2018.json");
+ADD_SERIALIZE_BENCHMARK(RapidJSON_Default_Serialize, "gsoc-2018.json");
+ADD_SERIALIZE_BENCHMARK(RapidJSON_PMR_Monotonic_Serialize, "gsoc-2018.json");
+ADD_SERIALIZE_BENCHMARK(RapidJSON_Fixed_Buffer_Serialize, "gsoc-2018.json");
+ADD_SERIALIZE_BENCHMARK(nlohmann_JSON_Default_Dump, "gsoc-2018.json");
+ADD_SERIALIZE_BENCHMARK(nlohmann_JSON_PMR_Monotonic_Dump, "gsoc-2018.json");
+ADD_SERIALIZE_BENCHMARK(nlohmann_JSON_Fixed_Buffer_Dump, "gsoc-2018.json");
+
+ADD_SERIALIZE_BENCHMARK(Boost_JSON_Default_Serialize, "github_events.json");
+ADD_SERIALIZE_BENCHMARK(Boost_JSON_PMR_Monotonic_Serialize, "github_events.json");
+ADD_SERIALIZE_BENCHMARK(Boost_JSON_Fixed_Buffer_Serialize, "github_events.json");
+ADD_SERIALIZE_BENCHMARK(RapidJSON_Default_Serialize, "github_events.json");
+ADD_SERIALIZE_BENCHMARK(RapidJSON_PMR_Monotonic_Serialize, "github_events.json");
+ADD_SERIALIZE_BENCHMARK(RapidJSON_Fixed_Buffer_Serialize, "github_events.json");
+ADD_SERIALIZE_BENCHMARK(nlohmann_JSON_Default_Dump, "github_events.json");
+ADD_SERIALIZE_BENCHMARK(nlohmann_JSON_PMR_Monotonic_Dump, "github_events.json");
+ADD_SERIALIZE_BENCHMARK(nlohmann_JSON_Fixed_Buffer_Dump, "github_events.json");
+
+
+// Warm parsers. A server keeps its parsers and arenas around between requests, so these
+// reuse one parser and one arena for every iteration. The cost of the very first parse on
+// a brand new parser and arena is reported separately as cold_us, and the size that the
+// arena settled at is reported as arena_bytes.
+
+template<typename Func> double time_once_us(Func &&func)
+{
+  const auto start = std::chrono::steady_clock::now();
+  func();
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void Boost_JSON_PMR_Monotonic_Warm_Parse(benchmark::State &state, std::string_view s)
+{
+  const auto parse = [s](boost::json::stream_parser &p, std::pmr::polymorphic_allocator<> pa) {
+    boost::json::error_code ec;
+    p.reset(pa);
+    p.write(s.data(), s.size(), ec);
+    if (!ec)
+      p.finish(ec);
+    if (!ec)
+      auto jv = p.release();
+  };
+
+  // the parser's own temporary buffers stay warm from here on
+  boost::json::stream_parser p;
+
+  PeakTrackingResource tracker;
+  const auto cold_us = time_once_us([&] {
+    std::pmr::monotonic_buffer_resource cold_mr{ &tracker };
+    parse(p, std::pmr::polymorphic_allocator<>{ &cold_mr });
+  });
+
+  // big enough for a whole document, so that release() just rewinds to the start of the
+  // buffer and nothing is ever asked of the upstream resource
+  std::vector<std::byte> arena(tracker.peak());
+  std::pmr::monotonic_buffer_resource mr{ arena.data(), arena.size() };
+
+  for (auto _ : LatencyRecorder{ state }) {
+    mr.release();
+    parse(p, std::pmr::polymorphic_allocator<>{ &mr });
+  }
+
+  state.counters["cold_us"] = cold_us;
+  state.counters["arena_bytes"] = static_cast<double>(arena.size());
+}
+
+static void RapidJSON_Pool_Warm_Parse(benchmark::State &state, std::string_view s)
+{
+  using namespace rapidjson;
+
+  std::size_t arena_size = 0;
+  const auto cold_us = time_once_us([&] {
+    Document d;
+    d.Parse(s.data(), s.size());
+    arena_size = d.GetAllocator().Capacity();
+  });
+
+  // Clear() frees every chunk the pool allocated itself and keeps only a buffer it was
+  // given, where it just resets the used size. So the pool gets a buffer with room for the
+  // whole document, and for the bookkeeping that the pool keeps at its start, and never
+  // allocates once it's warm.
+  std::vector<char> buffer(arena_size + 1024);
+  MemoryPoolAllocator<> pool{ buffer.data(), buffer.size() };
+  Document d{ &pool };
+  const auto capacity = pool.Capacity();
+  bool grown = false;
+
+  for (auto _ : LatencyRecorder{ state }) {
+    // values from the last iteration are never freed with a pool allocator, so it's fine
+    // for the document to still be pointing at them until Parse() replaces the root
+    pool.Clear();
+    d.Parse(s.data(), s.size());
+    grown = grown || pool.Capacity() != capacity;
+  }
+
+  if (grown) {
+    state.SkipWithError("the document outgrew the buffer, so the pool allocated chunks of its own");
+  }
+  state.counters["cold_us"] = cold_us;
+  state.counters["arena_bytes"] = static_cast<double>(pool.Capacity());
+}
+
+ADD_BENCHMARK(Boost_JSON_PMR_Monotonic_Warm_Parse, "citm_catalog.json");
+ADD_BENCHMARK(RapidJSON_Pool_Warm_Parse, "citm_catalog.json");
+ADD_BENCHMARK(Boost_JSON_PMR_Monotonic_Warm_Parse, "gsoc-2018.json");
+ADD_BENCHMARK(RapidJSON_Pool_Warm_Parse, "gsoc-2018.json");
+ADD_BENCHMARK(Boost_JSON_PMR_Monotonic_Warm_Parse, "github_events.json");
+ADD_BENCHMARK(RapidJSON_Pool_Warm_Parse, "github_events.json");
+
+
+// --latency_histogram_dir=<dir> writes out the per iteration latency histograms
+int main(int argc, char **argv)
+{
+  return latency::run_benchmarks(argc, argv);
+}
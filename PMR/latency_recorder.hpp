@@ -0,0 +1,289 @@
+#ifndef CPP_WEEKLY_LATENCY_RECORDER_HPP
+#define CPP_WEEKLY_LATENCY_RECORDER_HPP
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Google Benchmark only reports the mean time per iteration, but allocator choices matter
+// most in the tail (a monotonic resource growing a chunk halfway through a request, for
+// example). LatencyRecorder times every single iteration into a histogram and reports the
+// percentiles as user counters.
+//
+// Usage: replace
+//     for (auto _ : state)
+// with
+//     for (auto _ : LatencyRecorder{ state })
+
+namespace latency {
+
+// HDR histogram style log-linear buckets: every power of two range is split into
+// sub_bucket_count linear buckets, so any recorded value is off by less than 1%
+class Histogram
+{
+public:
+  static constexpr unsigned sub_bucket_bits = 7;
+  static constexpr std::uint64_t sub_bucket_count = std::uint64_t{ 1 } << sub_bucket_bits;
+  static constexpr std::size_t bucket_groups = std::numeric_limits<std::uint64_t>::digits - sub_bucket_bits + 1;
+
+  void record(const std::uint64_t value)
+  {
+    ++counts[index_of(value)];
+    ++total;
+    min_value = std::min(min_value, value);
+    max_value = std::max(max_value, value);
+  }
+
+  void merge(const Histogram &other)
+  {
+    std::transform(counts.begin(), counts.end(), other.counts.begin(), counts.begin(), std::plus<>{});
+    total += other.total;
+    min_value = std::min(min_value, other.min_value);
+    max_value = std::max(max_value, other.max_value);
+  }
+
+  [[nodiscard]] std::uint64_t count() const noexcept { return total; }
+  [[nodiscard]] std::uint64_t min() const noexcept { return total == 0 ? 0 : min_value; }
+  [[nodiscard]] std::uint64_t max() const noexcept { return max_value; }
+
+  // highest value that is equivalent to the requested percentile, the same way HDR
+  // histogram reports it
+  [[nodiscard]] std::uint64_t percentile(const double percent) const
+  {
+    if (total == 0) {
+      return 0;
+    }
+
+    const auto target = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(static_cast<double>(total) * percent / 100.0 + 0.5));
+    std::uint64_t seen = 0;
+    for (std::size_t index = 0; index < counts.size(); ++index) {
+      seen += counts[index];
+      if (seen >= target) {
+        return std::min(highest_value_at(index), max_value);
+      }
+    }
+    return max_value;
+  }
+
+  // one line per non empty bucket: upper value, count in bucket, cumulative percentile
+  void write(std::ostream &os) const
+  {
+    os << "# value_ns count percentile\n";
+    std::uint64_t seen = 0;
+    for (std::size_t index = 0; index < counts.size(); ++index) {
+      if (counts[index] == 0) {
+        continue;
+      }
+      seen += counts[index];
+      os << std::min(highest_value_at(index), max_value) << ' ' << counts[index] << ' '
+         << 100.0 * static_cast<double>(seen) / static_cast<double>(total) << '\n';
+    }
+  }
+
+  [[nodiscard]] static constexpr std::size_t index_of(const std::uint64_t value) noexcept
+  {
+    if (value < sub_bucket_count) {
+      return static_cast<std::size_t>(value);
+    }
+    const auto shift = static_cast<unsigned>(std::bit_width(value)) - 1 - sub_bucket_bits;
+    return static_cast<std::size_t>((shift + 1) * sub_bucket_count + ((value >> shift) - sub_bucket_count));
+  }
+
+  [[nodiscard]] static constexpr std::uint64_t highest_value_at(const std::size_t index) noexcept
+  {
+    const auto group = index / sub_bucket_count;
+    const auto sub_bucket = index % sub_bucket_count;
+    if (group == 0) {
+      return sub_bucket;
+    }
+    return ((sub_bucket_count + sub_bucket + 1) << (group - 1)) - 1;
+  }
+
+private:
+  std::vector<std::uint64_t> counts = std::vector<std::uint64_t>(bucket_groups * sub_bucket_count);
+  std::uint64_t total = 0;
+  std::uint64_t min_value = std::numeric_limits<std::uint64_t>::max();
+  std::uint64_t max_value = 0;
+};
+
+static_assert(Histogram::index_of(Histogram::sub_bucket_count - 1) == Histogram::sub_bucket_count - 1);
+static_assert(Histogram::index_of(Histogram::sub_bucket_count) == Histogram::sub_bucket_count);
+static_assert(Histogram::highest_value_at(Histogram::index_of(1000)) >= 1000);
+static_assert(Histogram::index_of(std::numeric_limits<std::uint64_t>::max()) < Histogram::bucket_groups * Histogram::sub_bucket_count);
+
+// The histogram of the most recent run, all threads combined. Picked up by the
+// HistogramDumpingReporter right after Google Benchmark finishes with a benchmark.
+inline std::mutex last_histogram_mutex;
+inline std::optional<Histogram> last_histogram;
+inline benchmark::IterationCount last_histogram_iterations = 0;
+
+// The threads of the run in progress that have finished, combined, and how many they are.
+// Guarded by last_histogram_mutex as well.
+inline Histogram run_histogram;
+inline int run_finished_threads = 0;
+
+class HistogramDumpingReporter : public benchmark::ConsoleReporter
+{
+public:
+  explicit HistogramDumpingReporter(std::string directory_) : directory{ std::move(directory_) } {}
+
+  void ReportRuns(const std::vector<Run> &reports) override
+  {
+    benchmark::ConsoleReporter::ReportRuns(reports);
+
+    std::scoped_lock lock{ last_histogram_mutex };
+    if (!last_histogram) {
+      return;
+    }
+
+    for (const auto &run : reports) {
+      if (run.run_type != Run::RT_Iteration) {
+        continue;
+      }
+      std::ofstream file{ directory + '/' + file_name(run.benchmark_name()) };
+      file << "# " << run.benchmark_name() << '\n';
+      last_histogram->write(file);
+    }
+    last_histogram.reset();
+  }
+
+private:
+  static std::string file_name(std::string name)
+  {
+    std::replace_if(
+      name.begin(), name.end(), [](const char c) { return c == '/' || c == '<' || c == '>' || c == ':' || c == '"' || c == ' ' || c == ','; }, '_');
+    return name + ".hgrm";
+  }
+
+  std::string directory;
+};
+
+// Runs the benchmarks, and if --latency_histogram_dir=<dir> is given writes the latency
+// histogram of every benchmark into that directory for plotting
+inline int run_benchmarks(int argc, char **argv)
+{
+  constexpr std::string_view dir_flag = "--latency_histogram_dir=";
+
+  std::optional<std::string> directory;
+  const auto end = std::remove_if(argv + 1, argv + argc, [&](const char *arg) {
+    if (std::string_view{ arg }.starts_with(dir_flag)) {
+      directory = arg + dir_flag.size();
+      return true;
+    }
+    return false;
+  });
+  argc = static_cast<int>(end - argv);
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+
+  if (directory) {
+    HistogramDumpingReporter reporter{ *directory };
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+  } else {
+    benchmark::RunSpecifiedBenchmarks();
+  }
+  return 0;
+}
+
+}// namespace latency
+
+// Wraps the state's iteration so that every lap is recorded. Only one clock read per
+// iteration, the lap is the time between two consecutive increments.
+class LatencyRecorder
+{
+public:
+  using clock = std::chrono::steady_clock;
+
+  class iterator
+  {
+  public:
+    iterator(benchmark::State::StateIterator itr_, LatencyRecorder *recorder_) : itr{ itr_ }, recorder{ recorder_ } {}
+
+    auto operator*() const { return *itr; }
+
+    iterator &operator++()
+    {
+      recorder->lap();
+      ++itr;
+      return *this;
+    }
+
+    bool operator!=(const iterator &other) const { return itr != other.itr; }
+
+  private:
+    benchmark::State::StateIterator itr;
+    LatencyRecorder *recorder;
+  };
+
+  explicit LatencyRecorder(benchmark::State &state_) : state{ state_ } {}
+
+  LatencyRecorder(const LatencyRecorder &) = delete;
+  LatencyRecorder &operator=(const LatencyRecorder &) = delete;
+
+  ~LatencyRecorder()
+  {
+    std::scoped_lock lock{ latency::last_histogram_mutex };
+
+    // Percentiles of different threads neither add up nor average, so the last thread of a
+    // run to finish reports them from the histogram of all of them, and the others report
+    // nothing. Google Benchmark sums the counters of the threads, which leaves its values.
+    latency::run_histogram.merge(histogram);
+    if (++latency::run_finished_threads == state.threads()) {
+      const auto &all = latency::run_histogram;
+      state.counters["p50_ns"] = static_cast<double>(all.percentile(50.0));
+      state.counters["p90_ns"] = static_cast<double>(all.percentile(90.0));
+      state.counters["p99_ns"] = static_cast<double>(all.percentile(99.0));
+      state.counters["p999_ns"] = static_cast<double>(all.percentile(99.9));
+      state.counters["max_ns"] = static_cast<double>(all.max());
+      latency::run_histogram = latency::Histogram{};
+      latency::run_finished_threads = 0;
+    }
+
+    // Google Benchmark grows the iteration count from run to run until it settles, so a
+    // different count means a new run and replaces what was there. The threads of a multi
+    // threaded run (and repetitions) share the count and get combined.
+    if (latency::last_histogram && latency::last_histogram_iterations == state.max_iterations) {
+      latency::last_histogram->merge(histogram);
+    } else {
+      latency::last_histogram = std::move(histogram);
+      latency::last_histogram_iterations = state.max_iterations;
+    }
+  }
+
+  iterator begin()
+  {
+    auto itr = state.begin();
+    last = clock::now();
+    return { itr, this };
+  }
+
+  iterator end() { return { state.end(), this }; }
+
+private:
+  void lap()
+  {
+    const auto now = clock::now();
+    histogram.record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - last).count()));
+    last = now;
+  }
+
+  benchmark::State &state;
+  latency::Histogram histogram;
+  clock::time_point last;
+};
+
+#endif
@@ -0,0 +1,243 @@
+// Benchmarks for smallpt_modernized.cpp
+// Make : g++ -O3 -march=native -std=c++20 smallpt_bench.cpp -o smallpt_bench -lbenchmark -lfmt -ltbb
+//        or the smallpt_bench target of the CMake build
+// Usage: ./smallpt_bench --benchmark_filter=Intersect
+//        ./smallpt_bench --benchmark_filter="Rand48|Philox"
+//        ./smallpt_bench --benchmark_filter=Convergence  integrator 0 is recursive, 1 wavefront, 2 next event
+//                                                         sampling 0 is random, 1 Sobol, 2 blue noise
+#define SMALLPT_NO_MAIN
+#include "smallpt_modernized.cpp"
+
+#include <benchmark/benchmark.h>
+
+#include <deque>
+
+//// generated scenes ////
+
+/// count small spheres scattered through the box of the Cornell scene, at about the same
+/// density whatever their count so that every ray hits a few of them
+auto random_spheres(const std::size_t count) {
+    std::mt19937_64 prng{count};
+    std::uniform_real_distribution<double> unit{0., 1.};
+    const auto radius = 40. / std::cbrt(static_cast<double>(count));
+    // spheres can't be copied, or moved, so they stay where they are made
+    std::deque<Sphere> scene;
+    for (std::size_t i = 0; i < count; ++i) {
+        scene.emplace_back(radius * (.5 + unit(prng)), Vec{100 * unit(prng), 100 * unit(prng), 170 * unit(prng)},
+                           Vec{}, Vec{.75, .75, .75}, DIFF);
+    }
+    return scene;
+}
+
+/// rays from all over the scene in all directions
+auto random_rays(const std::size_t count) {
+    std::mt19937_64 prng{42};
+    std::uniform_real_distribution<double> unit{0., 1.}, signed_unit{-1., 1.};
+    std::vector<Ray> rays;
+    rays.reserve(count);
+    while (rays.size() < count) {
+        if (const auto d = Vec{signed_unit(prng), signed_unit(prng), signed_unit(prng)}; d.dot(d) > 1e-6) {
+            rays.push_back({{100 * unit(prng), 100 * unit(prng), 170 * unit(prng)}, d.norm()});
+        }
+    }
+    return rays;
+}
+
+/// rays from the camera of create_image() through random points of a width by height image
+auto camera_rays(const std::size_t count, const int width = 1024, const int height = 768) {
+    std::mt19937_64 prng{42};
+    std::uniform_real_distribution<double> unit{0., 1.};
+    constexpr auto o = Vec{50, 52, 295.6}, d = Vec{0, -0.042612, -1}.norm();
+    const auto cx = Vec{width * .5135 / height}, cy = (cx % d).norm() * .5135;
+    std::vector<Ray> rays;
+    rays.reserve(count);
+    // a pixel's worth of rays at a time, as Primary::packets traces them
+    while (rays.size() < count) {
+        const auto x = std::floor(width * unit(prng)), y = std::floor(height * unit(prng));
+        for (auto i = 0; i < 8 && rays.size() < count; ++i) {
+            const auto dd = (cx * ((x + unit(prng)) / width - .5) + cy * ((y + unit(prng)) / height - .5) + d).norm();
+            rays.push_back({o + dd * 140, dd});
+        }
+    }
+    return rays;
+}
+
+//// intersection ////
+
+constexpr auto ray_count = 4096;
+
+/// closest hits through the BVH over range(0) spheres, should grow about with log(range(0))
+static void BVH_Intersect(benchmark::State &state) {
+    const auto scene = random_spheres(static_cast<std::size_t>(state.range(0)));
+    const auto bvh = Bvh{ranges::to<std::vector>(ranges::views::transform(scene, [](const auto &s) { return bounds(s); }))};
+    const auto rays = random_rays(ray_count);
+
+    for (auto _ : state) {
+        for (const auto &r : rays) {
+            benchmark::DoNotOptimize(bvh.intersect(r, [&](const auto i, const auto &ray) { return scene[i].intersect(ray); }));
+        }
+    }
+    state.SetComplexityN(state.range(0));
+    state.counters["intersections"] = benchmark::Counter(static_cast<double>(state.iterations()) * ray_count, benchmark::Counter::kIsRate);
+    state.counters["nodes"] = static_cast<double>(bvh.node_count());
+}
+BENCHMARK(BVH_Intersect)->RangeMultiplier(8)->Range(8, 1 << 18)->Complexity(benchmark::oLogN);
+
+/// the same by testing every sphere, like intersect() used to
+static void Linear_Intersect(benchmark::State &state) {
+    const auto scene = random_spheres(static_cast<std::size_t>(state.range(0)));
+    const auto rays = random_rays(ray_count);
+
+    for (auto _ : state) {
+        for (const auto &r : rays) {
+            benchmark::DoNotOptimize(ranges::min(scene | ranges::views::transform([&](const auto &s) { return s.intersect(r); })));
+        }
+    }
+    state.SetComplexityN(state.range(0));
+    state.counters["intersections"] = benchmark::Counter(static_cast<double>(state.iterations()) * ray_count, benchmark::Counter::kIsRate);
+}
+BENCHMARK(Linear_Intersect)->RangeMultiplier(8)->Range(8, 1 << 12)->Complexity(benchmark::oN);
+
+#if SMALLPT_HAS_SIMD
+/// the same, simd::size() spheres at a time
+static void SoA_Intersect(benchmark::State &state) {
+    const auto scene = random_spheres(static_cast<std::size_t>(state.range(0)));
+    const auto soa = SphereSoa{scene};
+    const auto rays = random_rays(ray_count);
+
+    for (auto _ : state) {
+        for (const auto &r : rays) {
+            benchmark::DoNotOptimize(soa.intersect(r));
+        }
+    }
+    state.SetComplexityN(state.range(0));
+    state.counters["intersections"] = benchmark::Counter(static_cast<double>(state.iterations()) * ray_count, benchmark::Counter::kIsRate);
+}
+BENCHMARK(SoA_Intersect)->RangeMultiplier(8)->Range(8, 1 << 12)->Complexity(benchmark::oN);
+
+/// camera rays of the Cornell box, simd::size() at a time against each sphere
+static void Packet_Intersect(benchmark::State &state) {
+    const auto rays = camera_rays(ray_count);
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < rays.size(); i += simd::size()) {
+            std::array<Ray, simd::size()> packet;
+            std::copy_n(rays.begin() + static_cast<std::ptrdiff_t>(i), simd::size(), packet.begin());
+            benchmark::DoNotOptimize(scene_soa.intersect(packet));
+        }
+    }
+    state.counters["intersections"] = benchmark::Counter(static_cast<double>(state.iterations()) * ray_count, benchmark::Counter::kIsRate);
+}
+BENCHMARK(Packet_Intersect);
+#endif
+
+/// camera rays of the Cornell box one at a time
+static void Camera_Intersect(benchmark::State &state) {
+    const auto rays = camera_rays(ray_count);
+    for (auto _ : state) {
+        for (const auto &r : rays) {
+            benchmark::DoNotOptimize(intersect(r));
+        }
+    }
+    state.counters["intersections"] = benchmark::Counter(static_cast<double>(state.iterations()) * ray_count, benchmark::Counter::kIsRate);
+}
+BENCHMARK(Camera_Intersect);
+
+/// rays from all over the Cornell box
+static void Scene_Intersect(benchmark::State &state) {
+    const auto rays = random_rays(ray_count);
+    for (auto _ : state) {
+        for (const auto &r : rays) {
+            benchmark::DoNotOptimize(intersect(r));
+        }
+    }
+    state.counters["intersections"] = benchmark::Counter(static_cast<double>(state.iterations()) * ray_count, benchmark::Counter::kIsRate);
+}
+BENCHMARK(Scene_Intersect);
+
+//// random numbers ////
+
+constexpr auto number_count = 4096;
+
+/// the erand48 replacement that create_image() seeds for each row
+static void Rand48(benchmark::State &state) {
+    auto prng = rand48{42};
+    for (auto _ : state) {
+        for (auto i = 0; i < number_count; ++i) benchmark::DoNotOptimize(prng());
+    }
+    state.counters["numbers"] = benchmark::Counter(static_cast<double>(state.iterations()) * number_count, benchmark::Counter::kIsRate);
+}
+BENCHMARK(Rand48);
+
+/// a stream of the counter based Philox one number at a time
+static void Philox_Scalar(benchmark::State &state) {
+    auto prng = Philox{42, 0};
+    for (auto _ : state) {
+        for (auto i = 0; i < number_count; ++i) benchmark::DoNotOptimize(prng());
+    }
+    state.counters["numbers"] = benchmark::Counter(static_cast<double>(state.iterations()) * number_count, benchmark::Counter::kIsRate);
+}
+BENCHMARK(Philox_Scalar);
+
+/// the same stream, 8 numbers at a time
+static void Philox_Batch(benchmark::State &state) {
+    auto prng = Philox{42, 0};
+    for (auto _ : state) {
+        for (auto i = 0; i < number_count; i += 8) benchmark::DoNotOptimize(prng.batch());
+    }
+    state.counters["numbers"] = benchmark::Counter(static_cast<double>(state.iterations()) * number_count, benchmark::Counter::kIsRate);
+}
+BENCHMARK(Philox_Batch);
+
+/// a new stream for every camera ray, as render_progressive() makes them
+static void Philox_Streams(benchmark::State &state) {
+    const auto camera = Camera{1024, 768};
+    for (auto _ : state) {
+        for (auto i = 0; i < number_count; i += 2) {
+            auto stream = camera.stream(i % 1024, i / 1024, 0, 1, 0);
+            benchmark::DoNotOptimize(camera.ray(i % 1024, i / 1024, 0, 1, stream));
+        }
+    }
+    state.counters["numbers"] = benchmark::Counter(static_cast<double>(state.iterations()) * number_count, benchmark::Counter::kIsRate);
+}
+BENCHMARK(Philox_Streams);
+
+//// convergence ////
+
+constexpr auto convergence_width = 48, convergence_height = 36;
+
+/// the Cornell box at 4096 spp, near enough to the true image for the error of the few
+/// samples that Convergence takes, rendered on first use in some seconds. Its samples start
+/// far past those of Convergence, so that no image shares noise with it.
+const auto &reference_image() {
+    static const auto image = render_progressive(convergence_height, convergence_width, {.passes = 1024, .first_pass = 1 << 20}, {.integrator = Integrator::wavefront},
+                                                 [](const auto &) {}, [](const auto &, int, int, bool) {}).image();
+    return image;
+}
+
+/// the RMSE against reference_image() after range(2) passes of Integrator range(0) with
+/// Sampling range(1), for the error against the time: the time to an equal RMSE of
+/// next event estimation against pure path tracing, and which sampling takes the fewest
+/// samples to an error. The error falls with the square root of the samples, so of two
+/// runs the one with the smaller time * rmse^2 gets to an error first. None of them traces
+/// a sample of the reference, whatever it draws from, which would lower its error.
+static void Convergence(benchmark::State &state) {
+    const auto &reference = reference_image();
+    const auto settings = RenderSettings{.integrator = static_cast<Integrator>(state.range(0)), .sampling = static_cast<Sampling>(state.range(1))};
+    const auto passes = static_cast<int>(state.range(2));
+    std::vector<Vec> image;
+    for (auto _ : state) {
+        image = render_progressive(convergence_height, convergence_width, {.passes = passes}, settings,
+                                   [](const auto &) {}, [](const auto &, int, int, bool) {}).image();
+    }
+    auto squared = 0.;
+    for (std::size_t i = 0; i < image.size(); ++i) {
+        const auto error = image[i] - reference[i];
+        squared += error.dot(error);
+    }
+    state.counters["rmse"] = std::sqrt(squared / (3. * static_cast<double>(image.size())));
+    state.counters["spp"] = 4 * passes;
+}
+BENCHMARK(Convergence)->ArgsProduct({{0, 1, 2}, {0, 1, 2}, {1, 4, 16, 64}})->ArgNames({"integrator", "sampling", "passes"})->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,115 @@
+// Benchmarks smallpt_modernized.cpp against smallpt_dummy_const_everything.cpp, and the
+// ranges pipeline of create_image() against plain loops
+// Make : g++ -O3 -fopenmp -std=c++20 smallpt_compare.cpp -o smallpt_compare -lbenchmark -lfmt -ltbb
+//        add -march=native for the SIMD intersection of smallpt_modernized.cpp
+//        or the smallpt_compare target of the CMake build
+// Usage: ./smallpt_compare 2>/dev/null  (create_image() shows its progress on stderr)
+#define SMALLPT_NO_MAIN
+#include "smallpt_modernized.cpp"
+
+// the C-style one in a namespace of its own, its headers included before so that it only
+// adds its own names
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+namespace dummy {
+#include "smallpt_dummy_const_everything.cpp"
+}
+
+#include <benchmark/benchmark.h>
+
+#include <map>
+
+//// implementations ////
+
+/// an image as the 8 bit RGB that both write, top row first
+using Image = std::vector<unsigned char>;
+
+Image to_image(const std::vector<Vec> &pixels) {
+    Image image;
+    image.reserve(pixels.size() * 3);
+    for (const auto &p : pixels) {
+        for (const auto c : {p.x, p.y, p.z}) image.push_back(static_cast<unsigned char>(toInt(c)));
+    }
+    return image;
+}
+
+/// create_image() of smallpt_modernized.cpp, through its ranges pipeline
+Image modernized(const int width, const int height, const int spp) {
+    return to_image(create_image(height, width, spp / 4));
+}
+
+/// The same with plain loops in place of the pipeline, adding up in the same order for the
+/// same image. Rows are rendered in parallel as create_image() does.
+Image loops(const int width, const int height, const int spp) {
+    const auto samples = spp / 4;
+    const auto camera = Camera{width, height};
+    std::vector<Vec> pixels(static_cast<std::size_t>(width * height));
+    const auto rows = ranges::to<std::vector>(ranges::views::iota(0, height));
+    std::for_each(std::execution::par, rows.begin(), rows.end(), [&](const int y) {
+        auto prng = rand48{static_cast<uint64_t>(y * y * y) << 32};
+        for (auto x = 0; x < width; ++x) {
+            auto pixel = Vec{};
+            for (auto sy = 0; sy < 2; ++sy) {
+                auto row = Vec{};
+                for (auto sx = 0; sx < 2; ++sx) {
+                    auto r = Vec{};
+                    for (auto s = 0; s < samples; ++s) r = r + radiance(camera.ray(x, y, sx, sy, prng), prng) * (1. / samples);
+                    row = row + Vec{clamp(r.x), clamp(r.y), clamp(r.z)} * .25;
+                }
+                pixel = pixel + row;
+            }
+            pixels[static_cast<std::size_t>((height - 1 - y) * width + x)] = pixel;
+        }
+    });
+    return to_image(pixels);
+}
+
+/// smallpt_dummy_const_everything.cpp a row at a time, as its main() does
+Image dummy_const_everything(const int width, const int height, const int spp) {
+    Image image(static_cast<std::size_t>(width * height * 3));
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int y = 0; y < height; ++y) {
+        dummy::render_row(y, width, height, spp / 4, &image[static_cast<std::size_t>((height - 1 - y) * width * 3)]);
+    }
+    return image;
+}
+
+/// the image of create_image(), to check the others against
+const Image &expected_image(const int width, const int height, const int spp) {
+    static std::map<std::tuple<int, int, int>, Image> images;
+    auto [image, inserted] = images.try_emplace({width, height, spp});
+    if (inserted) image->second = modernized(width, height, spp);
+    return image->second;
+}
+
+//// rendering ////
+
+/// Renders the Cornell box range(0) pixels wide, 3 / 4 of that high, at range(1) spp. The
+/// images should match the one of create_image() but for rounding: the implementations
+/// draw the same random numbers for the same samples, and only add them up in another order.
+static void Render(benchmark::State &state, Image (*render)(int, int, int)) {
+    const auto width = static_cast<int>(state.range(0)), height = width * 3 / 4, spp = static_cast<int>(state.range(1));
+    Image image;
+    for (auto _ : state) {
+        image = render(width, height, spp);
+    }
+
+    const auto &expected = expected_image(width, height, spp);
+    auto mismatched = 0, worst = 0;
+    for (std::size_t i = 0; i < image.size(); ++i) {
+        const auto difference = std::abs(image[i] - expected[i]);
+        mismatched += difference != 0;
+        worst = std::max(worst, difference);
+    }
+    if (worst > 1) state.SkipWithError("the image differs from create_image()'s by more than rounding");
+    state.counters["samples"] = benchmark::Counter(static_cast<double>(state.iterations()) * width * height * spp, benchmark::Counter::kIsRate);
+    state.counters["mismatched"] = mismatched;  // 8 bit channels off by one
+}
+
+#define RENDER_ARGS ArgsProduct({{64, 128, 256}, {4, 16}})->ArgNames({"width", "spp"})->Unit(benchmark::kMillisecond)
+BENCHMARK_CAPTURE(Render, modernized, modernized)->RENDER_ARGS;
+BENCHMARK_CAPTURE(Render, loops, loops)->RENDER_ARGS;
+BENCHMARK_CAPTURE(Render, dummy_const_everything, dummy_const_everything)->RENDER_ARGS;
+
+BENCHMARK_MAIN();
@@ -2,7 +2,6 @@
 #include <stdio.h>  //        Remove "-fopenmp" for g++ version < 4.2
 #include <stdlib.h> // Make : g++ -O3 -fopenmp smallpt.cpp -o smallpt
 #include <array>
-#include <memory>
 
 /*
   // Tested for fun with corroutine for double generation
@@ -183,12 +182,11 @@ const Vec radiance(const Ray &r, int depth, unsigned short *Xi) {
                           radiance(Ray(x, tdir), depth, Xi) * Tr);
 }
 
-const Vec rCompute(const int x, const int y, const int sx, const int sy, const int samps, unsigned short* Xi, int s=0)
+const Vec rCompute(const int x, const int y, const int sx, const int sy, const int w, const int h, const int samps, unsigned short* Xi, int s=0)
 {
-  constexpr int w = 1024, h = 768;
   constexpr Ray cam {Vec(50, 52, 295.6), Vec(0, -0.042612, -1).norm()}; // cam pos, dir
-  constexpr Vec cx {w * .5135 / h};
-  constexpr Vec cy {(cx % cam.d).norm() * .5135};
+  const Vec cx {w * .5135 / h};
+  const Vec cy {(cx % cam.d).norm() * .5135};
   const double r1 = 2 * erand48(Xi);
   const double dx = r1 < 1 ? sqrt(r1) - 1 : 1 - sqrt(2 - r1);
   const double r2 = 2 * erand48(Xi);
@@ -205,39 +203,56 @@ const Vec rCompute(const int x, const int y, const int sx, const int sy, const i
   * at least they converge (between original version and the one from this version))
   *********************************************/
   const Vec dNorm = d.norm(); 
-  return (radiance(Ray(cam.o + dNorm * 140, dNorm), 0, Xi) * (1. / samps) + ((s<samps)?rCompute(x,y,sx,sy,samps,Xi,s+1):Vec()));
+  // traced before the next samples, which draw their random numbers after this one's
+  const Vec sample = radiance(Ray(cam.o + dNorm * 140, dNorm), 0, Xi) * (1. / samps);
+  return (sample + ((s + 1 < samps)?rCompute(x,y,sx,sy,w,h,samps,Xi,s+1):Vec()));
+}
+
+// Row y (from the bottom) of a w x h image as 8 bit RGB, subpixel after subpixel as smallpt does
+void render_row(const int y, const int w, const int h, const int samps, unsigned char *row)
+{
+  for (unsigned short x = 0, Xi[3] = {0, 0, static_cast<unsigned short>(y * y * y)};
+       x < w;
+       x++) // Loop cols
+  {
+    const Vec r00{rCompute(x,y,0,0,w,h,samps,Xi)};
+    const Vec r10{rCompute(x,y,1,0,w,h,samps,Xi)};
+    const Vec r01{rCompute(x,y,0,1,w,h,samps,Xi)};
+    const Vec r11{rCompute(x,y,1,1,w,h,samps,Xi)};
+    // Camera rays are pushed ^^^^^ forward to start in interior
+    const Vec c{((Vec(clamp(r00.x), clamp(r00.y), clamp(r00.z))
+          + Vec(clamp(r10.x), clamp(r10.y), clamp(r10.z)))
+          + (Vec(clamp(r01.x), clamp(r01.y), clamp(r01.z))
+          + Vec(clamp(r11.x), clamp(r11.y), clamp(r11.z))))
+                    * .25};
+    row[x * 3] = static_cast<unsigned char>(toInt(c.x));
+    row[x * 3 + 1] = static_cast<unsigned char>(toInt(c.y));
+    row[x * 3 + 2] = static_cast<unsigned char>(toInt(c.z));
+  }
 }
 
 
+#ifndef SMALLPT_NO_MAIN
 int main(const int argc, const char *argv[])
 {
   constexpr int w = 1024, h = 768;
   const int samps{argc == 2 ? atoi(argv[1]) / 4 : 1}; // # samples
-  
-  std::array<std::unique_ptr<const Vec>, w * h> c;
+
+  // Write image to binary PPM file, every row at its place as soon as it is done
+  FILE *f = fopen("image2.ppm", "wb");
+  const long header = fprintf(f, "P6\n%d %d\n%d\n", w, h, 255);
 
 #pragma omp parallel for schedule(dynamic, 1) // OpenMP
   for (int y = 0 ; y < h; y++ ) {                          // Loop over image rows
     fprintf(stderr, "\rRendering (%d spp) %5.2f%%", samps * 4, 100. * y / (h - 1));
-    for (unsigned short x = 0, Xi[3] = {0, 0, static_cast<unsigned short>(y * y * y)};
-         x < w;
-         x++) // Loop cols
+    std::array<unsigned char, w * 3> row;
+    render_row(y, w, h, samps, row.data());
+#pragma omp critical
     {
-      const Vec r00{rCompute(x,y,0,0,samps,Xi)};
-      const Vec r01{rCompute(x,y,0,1,samps,Xi)};
-      const Vec r10{rCompute(x,y,1,0,samps,Xi)};
-      const Vec r11{rCompute(x,y,1,1,samps,Xi)};
-      // Camera rays are pushed ^^^^^ forward to start in interior
-      const int i = (h - y - 1) * w + x;
-      c[i] = std::unique_ptr<const Vec>{new Vec((Vec(clamp(r00.x), clamp(r00.y), clamp(r00.z))
-            + Vec(clamp(r01.x), clamp(r01.y), clamp(r01.z))
-            + Vec(clamp(r10.x), clamp(r10.y), clamp(r10.z))
-            + Vec(clamp(r11.x), clamp(r11.y), clamp(r11.z)))
-                      * .25)};
+      fseek(f, header + long{h - y - 1} * w * 3, SEEK_SET);
+      fwrite(row.data(), 1, row.size(), f);
     }
   }
-  FILE *f = fopen("image2.ppm", "w"); // Write image to PPM file.
-  fprintf(f, "P3\n%d %d\n%d\n", w, h, 255);
-  for (int i = 0; i < w * h; i++)
-    fprintf(f, "%d %d %d ", toInt(c[i]->x), toInt(c[i]->y), toInt(c[i]->z));
+  fclose(f);
 }
+#endif
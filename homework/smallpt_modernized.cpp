@@ -1,10 +1,28 @@
 // smallpt, a Path Tracer by Kevin Beason, 2008
 // Remove "-fopenmp" for g++ version < 4.2
 // Make : g++ -O3 -fopenmp smallpt.cpp -o smallpt
+//        add -march=native for 4 or 8 spheres or rays per SIMD instruction
 // Usage: time ./smallpt 5000 && xv image.ppm
+//        ./smallpt --time 30 --every 10  renders for 30 s, writing image.ppm every 10 passes
+//        ./smallpt 5000 --pfm  writes the unclamped radiance to image.pfm instead
+//        ./smallpt 64 --sobol  samples Owen-scrambled Sobol points, or --blue-noise shifts them
+//        ./smallpt 64 --next-event  samples the light at each diffuse hit as well
 // modernized by Dvir Yitzchaki dvirtz@gmail.com
+#include <array>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <chrono>
 #include <cmath>   
 #include <concepts>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
 #include <tuple>
 #include <vector>
 #include <fmt/ostream.h>
@@ -12,12 +30,21 @@
 #include <algorithm>
 #include <cassert>
 #include <random>
+#include <string_view>
 #include <iostream>
 #include <numeric>
 #include <execution>
 #include <future>
 #include <range/v3/all.hpp>
 
+#if __has_include(<experimental/simd>)
+#include <experimental/simd>
+#define SMALLPT_HAS_SIMD 1
+namespace stdx = std::experimental;
+#else
+#define SMALLPT_HAS_SIMD 0
+#endif
+
 //// concepts ////
 
 /// VecLike is either Vec or anything with a tuple_size of 3 and all elements being convertible to double
@@ -75,6 +102,103 @@ private:
 
 using rand48 = linear_congruential_engine<0x5DEECE66DULL, 0xBULL, 0x1000000000000ULL>;
 
+/// mixes a 64 bit counter into a well spread seed (splitmix64)
+inline constexpr auto mix(std::uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/// Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3"): ten rounds
+/// of multiplies and xors that turn a 128 bit counter and a 64 bit key into 128 random bits.
+/// Each word holds 32 bits in a std::uint64_t, or in every lane of a SIMD vector of them.
+template<typename T = std::uint64_t>
+constexpr auto philox(std::array<T, 4> c, const std::uint64_t key) {
+    constexpr auto low = std::uint64_t{0xFFFFFFFF};
+    auto k0 = key & low, k1 = key >> 32;
+    for (auto round = 0; round < 10; ++round) {
+        const T p0 = c[0] * T(0xD2511F53), p1 = c[2] * T(0xCD9E8D57);
+        c = {(p1 >> 32) ^ c[1] ^ T(k0), p1 & T(low), (p0 >> 32) ^ c[3] ^ T(k1), p0 & T(low)};
+        k0 = (k0 + 0x9E3779B9) & low;
+        k1 = (k1 + 0xBB67AE85) & low;
+    }
+    return c;
+}
+
+// known answers of the reference implementation, Random123
+static_assert(philox({0, 0, 0, 0}, 0) == std::array<std::uint64_t, 4>{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8});
+static_assert(philox({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, 0x299f31d0a4093822) ==
+              std::array<std::uint64_t, 4>{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1});
+
+/// a double in [0, 1) from the top 53 of the 64 bits that the 32 of hi and lo make
+constexpr auto philox_unit(const auto &hi, const auto &lo) {
+    if constexpr (std::is_integral_v<std::remove_cvref_t<decltype(hi)>>) {
+        return static_cast<double>((hi << 32 | lo) >> 11) * 0x1p-53;
+    }
+#if SMALLPT_HAS_SIMD
+    else {
+        return stdx::static_simd_cast<double>((hi << 32 | lo) >> 11) * 0x1p-53;
+    }
+#endif
+}
+
+/// A constexpr PRNG with as many streams as there are pixels and samples: the numbers of
+/// stream of key are drawn from the blocks Philox makes of the counter (block, stream), two
+/// per block, so that no stream depends on the order the others are drawn in.
+class Philox {
+public:
+    constexpr Philox(const std::uint64_t key, const std::uint64_t stream) : key_{key}, stream_{stream} {}
+
+    constexpr double operator()() {
+        if (buffered_) {
+            buffered_ = false;
+            return next_;
+        }
+        const auto [c0, c1, c2, c3] = philox({block_ & 0xFFFFFFFF, block_ >> 32, stream_ & 0xFFFFFFFF, stream_ >> 32}, key_);
+        ++block_;
+        buffered_ = true;
+        next_ = philox_unit(c2, c3);
+        return philox_unit(c0, c1);
+    }
+
+    /// the next 8 numbers, as 8 calls would return them, from 4 blocks at once
+    auto batch() {
+        std::array<double, 8> numbers;  // of blocks block_ to block_ + 3, in the order of the stream
+#if SMALLPT_HAS_SIMD
+        using lanes = stdx::fixed_size_simd<std::uint64_t, 4>;
+        const auto block = lanes([&](const auto i) { return block_ + i; });
+        const auto [c0, c1, c2, c3] = philox<lanes>({block & 0xFFFFFFFF, block >> 32, lanes(stream_ & 0xFFFFFFFF), lanes(stream_ >> 32)}, key_);
+        const auto first = philox_unit(c0, c1), second = philox_unit(c2, c3);
+        for (std::size_t i = 0; i < 4; ++i) {
+            numbers[2 * i] = first[i];
+            numbers[2 * i + 1] = second[i];
+        }
+#else
+        for (std::uint64_t i = 0; i < 4; ++i) {
+            const auto [c0, c1, c2, c3] = philox({(block_ + i) & 0xFFFFFFFF, (block_ + i) >> 32, stream_ & 0xFFFFFFFF, stream_ >> 32}, key_);
+            numbers[2 * i] = philox_unit(c0, c1);
+            numbers[2 * i + 1] = philox_unit(c2, c3);
+        }
+#endif
+        block_ += 4;
+        if (buffered_) {  // comes first, and the last one waits for the next call instead
+            const auto last = numbers.back();
+            std::shift_right(numbers.begin(), numbers.end(), 1);
+            numbers.front() = std::exchange(next_, last);
+        }
+        return numbers;
+    }
+
+    /// a stream of its own for a path that splits off the one drawing from this
+    constexpr Philox fork() const { return {key_, mix(stream_ ^ mix(2 * block_ - buffered_))}; }
+
+private:
+    std::uint64_t key_, stream_, block_ = 0;
+    double next_ = 0;
+    bool buffered_ = false;
+};
+
 /// a constexpr square root
 constexpr auto csqrt(const arithmetic auto d)
 {
@@ -238,7 +362,7 @@ template <> struct fmt::formatter<Vec> {
   }
 
   template <typename FormatContext>
-  auto format(const Vec &v, FormatContext &ctx) -> decltype(ctx.out())
+  auto format(const Vec &v, FormatContext &ctx) const -> decltype(ctx.out())
   {
       return fmt::format_to(
           ctx.out(),
@@ -263,13 +387,15 @@ struct Sphere {
     Sphere(const Sphere&) = delete;
     Sphere& operator=(const Sphere&) = delete;
     // returns distance, 0 if no hit
-    constexpr auto intersect(const RayLike auto &r) const {
+    constexpr auto intersect(const RayLike auto &r) const { return distance(p, rad * rad, r); }
+    // the same for a sphere at p with a squared radius of rad2
+    static constexpr auto distance(const Vec &p, const double rad2, const RayLike auto &r) {
         const auto& [o, d] = r;
         // Solve t^2*d.d + 2*t*(p-o).d + (p-o).(p-o)-R^2 = 0
         const auto op = p - o;  
         const auto b = op.dot(d);
         const auto det = [&]{
-            const auto res = b * b - op.dot(op) + rad * rad;
+            const auto res = b * b - op.dot(op) + rad2;
             return (res > 0) ? csqrt(res) : res;
         }();
         if (det < 0)
@@ -297,20 +423,644 @@ constexpr Sphere spheres[] = {
     {600, {50, 681.6 - .27, 81.6}, {12, 12, 12}, {}, DIFF}      // Lite
 };
 
+//// acceleration structure ////
+
+/// axis aligned bounding box, empty by default
+struct Aabb {
+    Vec lo{inf, inf, inf}, hi{-inf, -inf, -inf};
+
+    constexpr auto grow(const Aabb &b) const {
+        return Aabb{{std::min(lo.x, b.lo.x), std::min(lo.y, b.lo.y), std::min(lo.z, b.lo.z)},
+                    {std::max(hi.x, b.hi.x), std::max(hi.y, b.hi.y), std::max(hi.z, b.hi.z)}};
+    }
+    constexpr auto grow(const VecLike auto &p) const { return grow(Aabb{p, p}); }
+    constexpr auto centroid() const { return (lo + hi) * .5; }
+    /// half the surface area, which is all the SAH needs
+    constexpr auto half_area() const {
+        if (lo.x > hi.x) return 0.;
+        const auto e = hi - lo;
+        return e.x * e.y + e.y * e.z + e.z * e.x;
+    }
+    /// where the ray enters the box, inf if it misses it or only gets there after t_max
+    constexpr auto hit(const VecLike auto &o, const VecLike auto &inv_d, const double t_max) const {
+        const auto t0 = (lo - o).mult(inv_d), t1 = (hi - o).mult(inv_d);
+        const auto t_enter = std::max({std::min(t0.x, t1.x), std::min(t0.y, t1.y), std::min(t0.z, t1.z), 0.});
+        const auto t_exit = std::min({std::max(t0.x, t1.x), std::max(t0.y, t1.y), std::max(t0.z, t1.z), t_max});
+        return t_enter <= t_exit ? t_enter : inf;
+    }
+};
+
+constexpr auto component(const VecLike auto &v, const int axis) {
+    const auto& [x, y, z] = v;
+    return axis == 0 ? x : axis == 1 ? y : z;
+}
+
+constexpr auto bounds(const Sphere &s) {
+    const auto r = Vec{s.rad, s.rad, s.rad};
+    return Aabb{s.p - r, s.p + r};
+}
+
+/// Bounding volume hierarchy over primitives that it only knows by their bounds and index.
+/// Built top down, splitting each node where the surface area heuristic says across a few
+/// bins of centroids. The nodes are one flat array in depth first order, so the left child
+/// of a node is the next one and only the right one is stored, and it's traversed with a
+/// small stack instead of recursion, nearer child first.
+class Bvh {
+public:
+    constexpr explicit Bvh(const std::vector<Aabb> &boxes) : indices(boxes.size()) {
+        std::iota(indices.begin(), indices.end(), std::uint32_t{});
+        nodes.reserve(2 * boxes.size());
+        build(boxes, 0, static_cast<std::uint32_t>(boxes.size()));
+    }
+
+    /// the closest hit as (distance, primitive index), distance is inf if nothing is hit.
+    /// hit(index, r) is the distance to a primitive, inf if r misses it.
+    constexpr auto intersect(const RayLike auto &r, auto &&hit) const {
+        const auto& [o, d] = r;
+        const auto inv_d = Vec{1 / d.x, 1 / d.y, 1 / d.z};
+        auto closest = std::make_pair(inf, std::size_t{});
+        if (nodes.empty()) return closest;
+
+        std::array<std::uint32_t, max_depth> stack{};
+        std::size_t size = 0;
+        auto node = std::uint32_t{};
+        while (true) {
+            const auto &n = nodes[node];
+            if (n.count > 0) {
+                for (auto i = n.start; i < n.start + n.count; ++i) {
+                    if (const auto t = hit(indices[i], r); t < closest.first) {
+                        closest = {t, indices[i]};
+                    }
+                }
+            } else {
+                // left is next to node, so near and far only need telling apart
+                const auto left = node + 1, right = n.start;
+                const auto [near, far] = component(d, n.axis) < 0 ? std::pair{right, left} : std::pair{left, right};
+                const auto t_near = nodes[near].box.hit(o, inv_d, closest.first), t_far = nodes[far].box.hit(o, inv_d, closest.first);
+                if (t_near < inf) {
+                    if (t_far < inf) stack[size++] = far;
+                    node = near;
+                    continue;
+                }
+                if (t_far < inf) {
+                    node = far;
+                    continue;
+                }
+            }
+            // the stack can hold nodes that the closest hit has moved out of reach since
+            do {
+                if (size == 0) return closest;
+                node = stack[--size];
+            } while (nodes[node].box.hit(o, inv_d, closest.first) == inf);
+        }
+    }
+
+    constexpr auto node_count() const { return nodes.size(); }
+
+private:
+    struct Node {
+        Aabb box;
+        std::uint32_t start = 0;  // first index of a leaf, right child of an inner node
+        std::uint32_t count = 0;  // primitives in a leaf, 0 for an inner node
+        std::uint32_t axis = 0;   // split axis of an inner node
+    };
+
+    static constexpr auto bin_count = 12;
+    static constexpr auto max_leaf_size = 4;
+    // SAH costs of a traversal step and of a primitive test
+    static constexpr auto traversal_cost = 1., intersection_cost = 1.;
+    // deep enough for any sane scene, deeper subtrees are cut off into leaves
+    static constexpr std::size_t max_depth = 64;
+
+    constexpr std::uint32_t build(const std::vector<Aabb> &boxes, const std::uint32_t begin, const std::uint32_t end, const std::size_t depth = 0) {
+        const auto node = static_cast<std::uint32_t>(nodes.size());
+        nodes.push_back({});
+
+        auto box = Aabb{}, centroids = Aabb{};
+        for (auto i = begin; i < end; ++i) {
+            box = box.grow(boxes[indices[i]]);
+            centroids = centroids.grow(boxes[indices[i]].centroid());
+        }
+        nodes[node].box = box;
+
+        const auto count = end - begin;
+        const auto make_leaf = [&] {
+            nodes[node].start = begin;
+            nodes[node].count = count;
+            return node;
+        };
+        if (count <= max_leaf_size) return make_leaf();
+
+        // the cheapest split over all axes and bin boundaries
+        struct Split { double cost = inf; int axis = 0; int bin = 0; };
+        auto best = Split{};
+        for (auto axis = 0; axis < 3; ++axis) {
+            const auto lo = component(centroids.lo, axis), extent = component(centroids.hi, axis) - lo;
+            if (extent <= 0) continue;
+
+            // GCC 12 zeroes all but the first few of them when they're value initialized
+            std::array<Aabb, bin_count> bin_boxes;
+            bin_boxes.fill(Aabb{});
+            std::array<std::uint32_t, bin_count> bin_counts{};
+            for (auto i = begin; i < end; ++i) {
+                const auto bin = bin_of(component(boxes[indices[i]].centroid(), axis), lo, extent);
+                bin_boxes[bin] = bin_boxes[bin].grow(boxes[indices[i]]);
+                ++bin_counts[bin];
+            }
+
+            // sweep from the right for the costs of everything right of each boundary
+            std::array<double, bin_count> right_costs{};
+            auto right_box = Aabb{};
+            auto right_count = std::uint32_t{};
+            for (auto bin = bin_count - 1; bin > 0; --bin) {
+                right_box = right_box.grow(bin_boxes[bin]);
+                right_count += bin_counts[bin];
+                right_costs[bin] = right_box.half_area() * right_count;
+            }
+            auto left_box = Aabb{};
+            auto left_count = std::uint32_t{};
+            for (auto bin = 1; bin < bin_count; ++bin) {
+                left_box = left_box.grow(bin_boxes[bin - 1]);
+                left_count += bin_counts[bin - 1];
+                if (const auto cost = left_box.half_area() * left_count + right_costs[bin]; left_count > 0 && left_count < count && cost < best.cost) {
+                    best = {cost, axis, bin};
+                }
+            }
+        }
+
+        // all the centroids in one place can't be split apart
+        if (best.cost == inf) return make_leaf();
+        const auto leaf_cost = intersection_cost * count;
+        const auto split_cost = traversal_cost + intersection_cost * best.cost / box.half_area();
+        if (split_cost >= leaf_cost || depth + 1 >= max_depth) return make_leaf();
+
+        const auto lo = component(centroids.lo, best.axis), extent = component(centroids.hi, best.axis) - lo;
+        const auto mid = static_cast<std::uint32_t>(std::partition(indices.begin() + begin, indices.begin() + end, [&](const auto i) {
+            return bin_of(component(boxes[i].centroid(), best.axis), lo, extent) < best.bin;
+        }) - indices.begin());
+
+        nodes[node].axis = static_cast<std::uint32_t>(best.axis);
+        build(boxes, begin, mid, depth + 1);
+        nodes[node].start = build(boxes, mid, end, depth + 1);
+        return node;
+    }
+
+    static constexpr int bin_of(const double centroid, const double lo, const double extent) {
+        return std::min(static_cast<int>(bin_count * (centroid - lo) / extent), bin_count - 1);
+    }
+
+    std::vector<Node> nodes;
+    std::vector<std::uint32_t> indices;
+};
+
+
+#if SMALLPT_HAS_SIMD
+//// SIMD intersection ////
+
+using simd = stdx::native_simd<double>;
+
+/// Sphere::intersect for a lane of spheres or rays at once, given p - o and d of each lane
+inline auto sphere_distance(const simd &opx, const simd &opy, const simd &opz,
+                            const simd &dx, const simd &dy, const simd &dz, const simd &rad2) {
+    const auto b = opx * dx + opy * dy + opz * dz;
+    const auto det2 = b * b - (opx * opx + opy * opy + opz * opz) + rad2;
+    const auto det = stdx::sqrt(stdx::max(det2, simd{0}));
+    const auto near = b - det, far = b + det;
+    auto t = simd{inf};
+    stdx::where(far > eps, t) = far;
+    stdx::where(near > eps, t) = near;
+    stdx::where(det2 < 0, t) = inf;
+    return t;
+}
+
+/// Spheres as a structure of arrays, to test one ray against simd::size() of them at a time
+/// or simd::size() rays against each of them. The result is the same as Sphere::intersect
+/// on every sphere, as (distance, index) pairs like Bvh::intersect gives. The arrays are
+/// its own, or those of a BakedScene.
+template<typename Values = std::vector<double>>
+class SphereSoa {
+public:
+    explicit SphereSoa(const ranges::range auto &spheres) {
+        for (const auto &s : spheres) push(s.p, s.rad * s.rad);
+        count = x.size();
+        // padded to whole vectors with spheres that nothing hits
+        while (x.size() % simd::size() != 0) push(Vec{}, -inf);
+    }
+    /// count spheres of arrays already padded
+    constexpr SphereSoa(const Values &x_, const Values &y_, const Values &z_, const Values &rad2_, const std::size_t count_)
+        : x(x_), y(y_), z(z_), rad2(rad2_), count(count_) {}
+
+    /// the closest hit of r, ties going to the last sphere
+    auto intersect(const RayLike auto &r) const {
+        const auto& [o, d] = r;
+        const auto lanes = lane_indices();
+        auto best_t = simd{inf}, best_index = simd{0};
+        for (std::size_t i = 0; i < x.size(); i += simd::size()) {
+            const auto t = sphere_distance(load(x, i) - o.x, load(y, i) - o.y, load(z, i) - o.z, d.x, d.y, d.z, load(rad2, i));
+            const auto closer = t <= best_t && t < inf;
+            stdx::where(closer, best_t) = t;
+            stdx::where(closer, best_index) = lanes + static_cast<double>(i);
+        }
+        auto closest = std::make_pair(inf, std::size_t{});
+        for (std::size_t lane = 0; lane < simd::size(); ++lane) {
+            const auto index = static_cast<std::size_t>(best_index[lane]);
+            if (best_t[lane] < closest.first || (best_t[lane] < inf && best_t[lane] == closest.first && index > closest.second)) {
+                closest = {best_t[lane], index};
+            }
+        }
+        return closest;
+    }
+
+    /// the closest hits of a packet of rays, one per lane, which is cheapest when they go
+    /// about the same way, like the camera rays of a pixel
+    auto intersect(const std::array<Ray, simd::size()> &rays) const {
+        const auto lane = [&](const auto component) {
+            return simd{[&](const auto l) { return component(rays[l]); }};
+        };
+        const auto ox = lane([](const Ray &r) { return r.o.x; }), oy = lane([](const Ray &r) { return r.o.y; }), oz = lane([](const Ray &r) { return r.o.z; });
+        const auto dx = lane([](const Ray &r) { return r.d.x; }), dy = lane([](const Ray &r) { return r.d.y; }), dz = lane([](const Ray &r) { return r.d.z; });
+        auto best_t = simd{inf}, best_index = simd{0};
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto t = sphere_distance(x[i] - ox, y[i] - oy, z[i] - oz, dx, dy, dz, rad2[i]);
+            const auto closer = t <= best_t && t < inf;
+            stdx::where(closer, best_t) = t;
+            stdx::where(closer, best_index) = static_cast<double>(i);
+        }
+        std::array<std::pair<double, std::size_t>, simd::size()> closest;
+        for (std::size_t l = 0; l < simd::size(); ++l) {
+            closest[l] = {best_t[l], static_cast<std::size_t>(best_index[l])};
+        }
+        return closest;
+    }
+
+private:
+    void push(const Vec &p, const double r2) {
+        x.push_back(p.x);
+        y.push_back(p.y);
+        z.push_back(p.z);
+        rad2.push_back(r2);
+    }
+    static simd load(const Values &v, const std::size_t i) { return simd{&v[i], stdx::element_aligned}; }
+    static simd lane_indices() { return simd{[](const auto l) { return static_cast<double>(l); }}; }
+
+    Values x, y, z, rad2;
+    std::size_t count = 0;
+};
+
+/// up to this many spheres are tested faster all at once than through the BVH
+inline constexpr auto max_soa_spheres = 4 * simd::size();
+#endif
+
+//// baked scene ////
+
+/// what the structure of arrays of a scene is padded to
+#if SMALLPT_HAS_SIMD
+inline constexpr auto soa_lanes = simd::size();
+#else
+inline constexpr auto soa_lanes = std::size_t{1};
+#endif
+
+/// What of a scene doesn't depend on the rays, worked out once at compile time by bake():
+/// the spheres as a structure of arrays padded to whole SIMD vectors, their squared radii,
+/// which of them end every path that hits them, their bounds and the lights.
+template<std::size_t Count, std::size_t Padded, std::size_t Lights>
+struct BakedScene {
+    static constexpr auto count = Count;
+    std::array<double, Padded> x, y, z, rad2;  // centres and squared radii, the padding hit by nothing
+    std::array<bool, Count> emission_only;     // black, so that no light comes from further on
+    std::array<Aabb, Count> bounds;
+    Aabb box;                                  // of them all
+    std::array<std::size_t, Lights> lights;    // the spheres that emit
+
+    /// Sphere::intersect of sphere i
+    constexpr auto intersect(const std::size_t i, const RayLike auto &r) const {
+        return Sphere::distance(Vec{x[i], y[i], z[i]}, rad2[i], r);
+    }
+};
+
+/// the BakedScene of the spheres of scene
+template<const auto &scene>
+consteval auto bake() {
+    constexpr auto emits = [](const Sphere &s) { return s.e.x > 0 || s.e.y > 0 || s.e.z > 0; };
+    constexpr auto count = std::size(scene), padded = (count + soa_lanes - 1) / soa_lanes * soa_lanes;
+    constexpr auto lights = static_cast<std::size_t>(std::count_if(std::begin(scene), std::end(scene), emits));
+
+    BakedScene<count, padded, lights> baked{};
+    for (std::size_t i = 0, light = 0; i < padded; ++i) {
+        if (i >= count) {
+            baked.rad2[i] = -inf;
+            continue;
+        }
+        const auto &s = scene[i];
+        baked.x[i] = s.p.x;
+        baked.y[i] = s.p.y;
+        baked.z[i] = s.p.z;
+        baked.rad2[i] = s.rad * s.rad;
+        baked.emission_only[i] = s.c.x == 0 && s.c.y == 0 && s.c.z == 0;
+        baked.bounds[i] = bounds(s);
+        baked.box = baked.box.grow(baked.bounds[i]);
+        if (emits(s)) baked.lights[light++] = i;
+    }
+    return baked;
+}
+
+inline constexpr auto baked_scene = bake<spheres>();
+static_assert(baked_scene.lights.size() == 1 && baked_scene.lights[0] == 8 && baked_scene.emission_only[3] && baked_scene.emission_only[8]);
+
+inline const auto scene_bvh = Bvh{std::vector<Aabb>(baked_scene.bounds.begin(), baked_scene.bounds.end())};
+
+#if SMALLPT_HAS_SIMD
+/// the arrays of baked_scene as they are, for the SIMD kernels
+inline constexpr auto scene_soa = SphereSoa<std::span<const double>>{baked_scene.x, baked_scene.y, baked_scene.z, baked_scene.rad2, baked_scene.count};
+#endif
+
+/// the index of a sphere of spheres
+inline constexpr auto index_of(const Sphere &s) { return static_cast<std::size_t>(&s - std::begin(spheres)); }
+
+/// A sampler that draws for one sample alone, so that what a path draws, or doesn't, leaves
+/// the others as they are. Unlike the rand48 that a row of create_image() shares.
+template<typename T>
+concept SampleStream = requires(const T &prng) { { prng.fork() } -> std::same_as<T>; };
+
+/// (hit, distance, sphere) from the (distance, index) of a closest hit
+inline constexpr auto to_hit(const double t, const std::size_t index) {
+    return std::make_tuple(t < inf, t, std::cref(spheres[index]));
+}
+
+/// the (distance, index) of the closest sphere along r
+inline constexpr auto closest_hit(const RayLike auto &r) {
+    if (std::is_constant_evaluated()) {
+        // ties go to the last sphere, as they always have
+        auto closest = std::make_pair(inf, std::size_t{});
+        for (auto i = baked_scene.count; i-- > 0;) {
+            if (const auto t = baked_scene.intersect(i, r); t < closest.first) closest = {t, i};
+        }
+        return closest;
+    }
+#if SMALLPT_HAS_SIMD
+    if constexpr (std::size(spheres) <= max_soa_spheres) {
+        return scene_soa.intersect(r);
+    }
+#endif
+    return scene_bvh.intersect(r, [](const auto i, const auto &ray) { return baked_scene.intersect(i, ray); });
+}
+
 inline constexpr auto intersect(const RayLike auto &r) {
-    const auto it = ranges::min_element(ranges::views::reverse(spheres), {}, [&](const auto& s){
-      return s.intersect(r);
-    });
-    assert(it != ranges::rend(spheres));
-    const auto t = (*it).intersect(r);
-    return std::make_tuple(t < inf, t, std::ref(*it));
+    const auto [t, index] = closest_hit(r);
+    return to_hit(t, index);
 }
 
-auto constexpr radiance(const RayLike auto &r, auto& prng, const int depth = 1) {
+/// closest_hit() of every ray, in packets where the spheres are few enough to be tested
+/// all at once anyway
+constexpr auto closest_hits(const ranges::random_access_range auto &rays) {
+    const auto count = static_cast<std::size_t>(ranges::size(rays));
+    std::vector<std::pair<double, std::size_t>> hits(count);
+#if SMALLPT_HAS_SIMD
+    if (std::size(spheres) <= max_soa_spheres && not std::is_constant_evaluated()) {
+        for (std::size_t i = 0; i < count; i += simd::size()) {
+            // the last packet is topped up with copies of the last ray
+            std::array<Ray, simd::size()> packet;
+            for (std::size_t lane = 0; lane < simd::size(); ++lane) packet[lane] = rays[std::min(i + lane, count - 1)];
+            const auto packet_hits = scene_soa.intersect(packet);
+            std::copy_n(packet_hits.begin(), std::min(simd::size(), count - i), hits.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+        return hits;
+    }
+#endif
+    for (std::size_t i = 0; i < count; ++i) hits[i] = closest_hit(rays[i]);
+    return hits;
+}
+
+//// low discrepancy sampling ////
+
+/// the 32 bits of x in reverse order
+inline constexpr auto reverse_bits(std::uint32_t x) {
+    x = (x << 16) | (x >> 16);
+    x = ((x & 0x00FF00FF) << 8) | ((x >> 8) & 0x00FF00FF);
+    x = ((x & 0x0F0F0F0F) << 4) | ((x >> 4) & 0x0F0F0F0F);
+    x = ((x & 0x33333333) << 2) | ((x >> 2) & 0x33333333);
+    return ((x & 0x55555555) << 1) | ((x >> 1) & 0x55555555);
+}
+
+/// Owen scrambling of the fraction x / 2^32: each bit flipped or not by a hash of seed and
+/// the bits above it (Burley, "Practical Hash-based Owen Scrambling", 2020)
+inline constexpr auto owen_scramble(std::uint32_t x, const std::uint32_t seed) {
+    x = reverse_bits(x) + seed;
+    x ^= x * 0x6c50b47cu;
+    x ^= x * 0xb82f1e52u;
+    x ^= x * 0xc7afe638u;
+    x ^= x * 0x8d22f6e6u;
+    return reverse_bits(x);
+}
+
+/// the second dimension of the Sobol sequence, as the xor of what each byte of the index
+/// adds to it: the columns of its generator matrix, each the one before xor itself >> 1
+inline constexpr auto sobol_second_dimension = [] {
+    std::array<std::array<std::uint32_t, 256>, 4> bytes{};
+    std::array<std::uint32_t, 32> columns{};
+    columns[0] = 1u << 31;
+    for (std::size_t bit = 1; bit < columns.size(); ++bit) columns[bit] = columns[bit - 1] ^ (columns[bit - 1] >> 1);
+    for (std::size_t byte = 0; byte < bytes.size(); ++byte) {
+        for (std::size_t value = 0; value < 256; ++value) {
+            for (std::size_t bit = 0; bit < 8; ++bit) {
+                if (value >> bit & 1) bytes[byte][value] ^= columns[byte * 8 + bit];
+            }
+        }
+    }
+    return bytes;
+}();
+
+/// the first two dimensions of the Sobol sequence at index, as fractions of 2^32
+inline constexpr auto sobol_2d(const std::uint32_t index) {
+    const auto &bytes = sobol_second_dimension;
+    return std::pair{reverse_bits(index), bytes[0][index & 0xFF] ^ bytes[1][index >> 8 & 0xFF] ^
+                                          bytes[2][index >> 16 & 0xFF] ^ bytes[3][index >> 24]};
+}
+
+static_assert(sobol_2d(1) == std::pair{1u << 31, 1u << 31} && sobol_2d(2) == std::pair{1u << 30, 3u << 30} &&
+              sobol_2d(3) == std::pair{3u << 30, 1u << 30});
+
+/// A 64 by 64 tile of blue noise by void and cluster (Ulichney, 1993): each pixel is the
+/// rank at which it joins a pattern that keeps its points as far apart as it can, over 4096.
+/// Made on first use, in some ten million steps.
+inline const auto &blue_noise() {
+    static const auto tile = [] {
+        constexpr auto size = 64, count = size * size;
+        constexpr auto sigma = 1.9;
+        std::vector<double> kernel(count), energy(count);  // kernel by toroidal offset
+        for (auto y = 0; y < size; ++y) {
+            for (auto x = 0; x < size; ++x) {
+                const auto dx = std::min(x, size - x), dy = std::min(y, size - y);
+                kernel[static_cast<std::size_t>(y * size + x)] = std::exp(-(dx * dx + dy * dy) / (2 * sigma * sigma));
+            }
+        }
+        std::vector<bool> pattern(count);
+        const auto set = [&](const int p, const bool on) {
+            pattern[static_cast<std::size_t>(p)] = on;
+            for (auto q = 0; q < count; ++q) {
+                const auto offset = ((q / size - p / size) & (size - 1)) * size + ((q - p) & (size - 1));
+                energy[static_cast<std::size_t>(q)] += on ? kernel[static_cast<std::size_t>(offset)] : -kernel[static_cast<std::size_t>(offset)];
+            }
+        };
+        // the point with the most energy around it, or the empty pixel with the least
+        const auto extreme = [&](const bool tightest_cluster) {
+            auto best = -1;
+            for (auto p = 0; p < count; ++p) {
+                const auto i = static_cast<std::size_t>(p);
+                if (pattern[i] == tightest_cluster &&
+                    (best < 0 || (tightest_cluster ? energy[i] > energy[static_cast<std::size_t>(best)] : energy[i] < energy[static_cast<std::size_t>(best)]))) {
+                    best = p;
+                }
+            }
+            return best;
+        };
+
+        // a tenth of the pixels at random, moved from clusters to voids until none is left
+        auto prng = std::mt19937{size};
+        auto initial = 0;
+        for (; initial < count / 10;) {
+            if (const auto p = static_cast<int>(prng() % count); !pattern[static_cast<std::size_t>(p)]) set(p, true), ++initial;
+        }
+        for (;;) {
+            const auto cluster = extreme(true);
+            set(cluster, false);
+            const auto void_ = extreme(false);
+            set(void_, true);
+            if (void_ == cluster) break;
+        }
+
+        // ranked by taking the initial points out, then filling the voids
+        std::vector<int> rank(count);
+        const auto initial_pattern = pattern;
+        const auto initial_energy = energy;
+        for (auto r = initial; r-- > 0;) {
+            const auto cluster = extreme(true);
+            set(cluster, false);
+            rank[static_cast<std::size_t>(cluster)] = r;
+        }
+        pattern = initial_pattern;
+        energy = initial_energy;
+        for (auto r = initial; r < count; ++r) {
+            const auto void_ = extreme(false);
+            set(void_, true);
+            rank[static_cast<std::size_t>(void_)] = r;
+        }
+        return rank | ranges::views::transform([](const auto r) { return (r + .5) / count; }) | ranges::to<std::vector>;
+    }();
+    return tile;
+}
+
+/// A sampler of Owen-scrambled Sobol points for the index-th sample of a subpixel, a call
+/// at a time along its path. Each call is the next dimension, taken from a 2D Sobol point
+/// of its own whose index is scrambled as well, so any dimension, or pair of them from a
+/// call to next_2d(), is well stratified over the first samples of the subpixel.
+///
+/// With a pixel, every pixel has the same points, shifted in each dimension by another part
+/// of the blue_noise() tile, so that the errors of neighbours tend to cancel out instead of
+/// adding up (Georgiev and Fajardo, "Blue-noise dithered sampling", 2016).
+class Sobol {
+public:
+    constexpr Sobol(const std::uint32_t index, const std::uint64_t seed) : index_{index}, seed_{seed} {}
+    Sobol(const std::uint32_t index, const std::uint64_t seed, const int x, const int y)
+        : index_{index}, seed_{seed}, tile_{&blue_noise()}, x_{x}, y_{y} {}
+
+    constexpr double operator()() { return next_2d().first; }
+
+    constexpr std::pair<double, double> next_2d() {
+        const auto seed = mix(seed_ ^ mix(dimension_));
+        const auto [x, y] = sobol_2d(owen_scramble(index_, static_cast<std::uint32_t>(seed)));
+        const auto u = owen_scramble(x, static_cast<std::uint32_t>(seed >> 32)) * 0x1p-32,
+                   v = owen_scramble(y, static_cast<std::uint32_t>(mix(seed))) * 0x1p-32;
+        ++dimension_;
+        if (tile_ == nullptr) return {u, v};
+        return {shift(u, 2 * dimension_ - 2), shift(v, 2 * dimension_ - 1)};
+    }
+
+    /// a sampler of its own for a path that splits off the one drawing from this
+    constexpr Sobol fork() const {
+        auto forked = *this;
+        forked.seed_ = mix(~seed_ ^ mix(dimension_));
+        return forked;
+    }
+
+private:
+    /// u moved around the unit interval by the tile at the offset of the dimension (R2 sequence)
+    double shift(const double u, const std::uint64_t dimension) const {
+        const auto offset = [&](const double alpha) {
+            const auto a = static_cast<double>(dimension) * alpha;
+            return static_cast<int>(64 * (a - std::floor(a)));
+        };
+        const auto tx = (x_ + offset(0.7548776662466927)) & 63, ty = (y_ + offset(0.5698402909980532)) & 63;
+        const auto shifted = u + (*tile_)[static_cast<std::size_t>(ty * 64 + tx)];
+        return shifted < 1 ? shifted : shifted - 1;
+    }
+
+    std::uint32_t index_;
+    std::uint64_t seed_, dimension_ = 0;
+    const std::vector<double> *tile_ = nullptr;
+    int x_ = 0, y_ = 0;
+};
+
+/// two numbers for a 2D sample: a point of a low discrepancy sampler, or the next two numbers
+inline constexpr std::pair<double, double> sample_2d(auto &prng) {
+    if constexpr (requires { prng.next_2d(); }) {
+        return prng.next_2d();
+    } else {
+        const auto u = prng();
+        return {u, prng()};
+    }
+}
+
+//// shading ////
+
+/// the mirror direction of d off a surface with normal n
+inline constexpr auto reflect(const VecLike auto &d, const VecLike auto &n) { return d - n * 2 * n.dot(d); }
+
+/// a cosine weighted direction around nl
+inline constexpr auto diffuse_direction(const VecLike auto &nl, auto &prng) {
+    const auto [u1, u2] = sample_2d(prng);
+    const auto r1 = 2 * M_PI * u1, r2 = u2, r2s = csqrt(r2);
+    const auto w = nl, u = ((fabs(w.x) > .1 ? Vec{0, 1} : Vec{1}) % w).norm(),
+        v = w % u;
+    return (u * cos(r1) * r2s + v * sin(r1) * r2s + w * csqrt(1 - r2)).norm();
+}
+
+/// what becomes of d at the surface of glass with normal n, nl facing d, by default all of it reflected
+struct Dielectric {
+    bool total_internal_reflection = true;
+    Vec tdir;                           // refracted direction
+    double Re = 1, Tr = 0;              // reflected and transmitted fractions
+    double P = 1, RP = 1, TP = 0;       // chance of following the reflection and the weights of either choice
+};
+
+inline constexpr auto dielectric(const VecLike auto &d, const VecLike auto &n, const VecLike auto &nl) {
+    const auto into = n.dot(nl) > 0;             // Ray from outside going in?
+    const auto nc = 1.0, nt = 1.5, nnt = into ? nc / nt : nt / nc, ddn = d.dot(nl);
+    if (auto cos2t = 1 - nnt * nnt * (1 - ddn * ddn);
+        cos2t < 0) {  // Total internal reflection
+        return Dielectric{};
+    } else {
+        const auto tdir =
+            (d * nnt - n * ((into ? 1 : -1) * (ddn * nnt + csqrt(cos2t))))
+                .norm();
+        const auto a = nt - nc, b = nt + nc, R0 = a * a / (b * b),
+             c = 1 - (into ? -ddn : tdir.dot(n));
+        const auto Re = R0 + (1 - R0) * c * c * c * c * c, Tr = 1 - Re,
+             P = .25 + .5 * Re, RP = Re / P, TP = Tr / (1 - P);
+        return Dielectric{false, tdir, Re, Tr, P, RP, TP};
+    }
+}
+
+/// radiance along r, which is already known to hit what intersect(r) would return
+auto constexpr radiance(const RayLike auto &r, const auto &hit, auto& prng, const int depth = 1) {
     // t is distance to intersection
     // obj is the intersected object
-    const auto [intersects, t, obj] = intersect(r);
+    const auto [intersects, t, obj] = hit;
     if (!intersects) return Vec();  // if miss, return black
+    if constexpr (SampleStream<std::remove_cvref_t<decltype(prng)>>) {
+        // nothing it could draw would add any light
+        if (baked_scene.emission_only[index_of(obj)]) return obj.e;
+    }
     const auto& [o, d] = r;
     const auto x = o + d * t, n = (x - obj.p).norm(),
          nl = n.dot(d) < 0 ? n : n * -1;
@@ -328,30 +1078,25 @@ auto constexpr radiance(const RayLike auto &r, auto& prng, const int depth = 1)
         return obj.e;  // R.R.
     }
     if (obj.refl == DIFF) {  // Ideal DIFFUSE reflection
-        const auto r1 = 2 * M_PI * prng(), r2 = prng(), r2s = csqrt(r2);
-        const auto w = nl, u = ((fabs(w.x) > .1 ? Vec{0, 1} : Vec{1}) % w).norm(),
-            v = w % u;
-        const auto new_d =
-            (u * cos(r1) * r2s + v * sin(r1) * r2s + w * csqrt(1 - r2)).norm();
+        const auto new_d = diffuse_direction(nl, prng);
         return obj.e + f.mult(radiance(Ray{x, new_d}, prng, depth + 1));
     } else if (obj.refl == SPEC)  // Ideal SPECULAR reflection
         return obj.e +
-               f.mult(radiance(Ray{x, d - n * 2 * n.dot(d)}, prng, depth + 1));
+               f.mult(radiance(Ray{x, reflect(d, n)}, prng, depth + 1));
     const auto reflRay =
-        Ray{x, d - n * 2 * n.dot(d)};  // Ideal dielectric REFRACTION
-    const auto into = n.dot(nl) > 0;             // Ray from outside going in?
-    const auto nc = 1.0, nt = 1.5, nnt = into ? nc / nt : nt / nc, ddn = d.dot(nl);
-    if (auto cos2t = 1 - nnt * nnt * (1 - ddn * ddn);
-        cos2t < 0) {  // Total internal reflection
+        Ray{x, reflect(d, n)};  // Ideal dielectric REFRACTION
+    if (const auto glass = dielectric(d, n, nl);
+        glass.total_internal_reflection) {
         return obj.e + f.mult(radiance(reflRay, prng, depth + 1));
     } else {
-        const auto tdir =
-            (d * nnt - n * ((into ? 1 : -1) * (ddn * nnt + csqrt(cos2t))))
-                .norm();
-        const auto a = nt - nc, b = nt + nc, R0 = a * a / (b * b),
-             c = 1 - (into ? -ddn : tdir.dot(n));
-        const auto Re = R0 + (1 - R0) * c * c * c * c * c, Tr = 1 - Re,
-             P = .25 + .5 * Re, RP = Re / P, TP = Tr / (1 - P);
+        const auto& [tir, tdir, Re, Tr, P, RP, TP] = glass;
+        if constexpr (SampleStream<std::remove_cvref_t<decltype(prng)>>) {  // the transmitted path draws from a stream of its own
+            if (depth <= 2) {
+                auto transmitted = prng.fork();
+                const auto reflected = radiance(reflRay, prng, depth + 1) * Re;
+                return obj.e + f.mult(reflected + radiance(Ray{x, tdir}, transmitted, depth + 1) * Tr);
+            }
+        }
         return obj.e +
                f.mult(depth > 2 ? (prng() < P
                                        ?  // Russian roulette
@@ -362,30 +1107,370 @@ auto constexpr radiance(const RayLike auto &r, auto& prng, const int depth = 1)
     }
 }
 
-constexpr auto create_image(concepts::integral auto height, concepts::integral auto width, concepts::integral auto samples) {
+auto constexpr radiance(const RayLike auto &r, auto& prng, const int depth = 1) {
+    return radiance(r, intersect(r), prng, depth);
+}
+
+/// The radiance along each of rays, like radiance() but breadth first: all the paths are
+/// intersected a bounce at a time, then shaded a material at a time, each carrying its
+/// throughput forward instead of multiplying it in on the way back from the recursion. A
+/// split at the glass adds a path. Each path draws from the stream of its ray, forked at
+/// a split, so it is traced as radiance() would trace that ray with that stream.
+template<typename Stream>
+constexpr auto radiance_wavefront(const std::vector<Ray> &rays, std::vector<Stream> streams) {
+    struct Path {
+        Ray ray;
+        Vec throughput;       // what the radiance found along ray counts for
+        int depth;
+        std::size_t sample;   // index of the ray it started from
+        Stream prng;
+    };
+    struct Bounce {
+        Path path;
+        Vec x, n, nl;         // hit point, normal and normal facing the ray
+    };
+
+    std::vector<Vec> result(rays.size());
+    std::vector<Path> paths, next;
+    std::array<std::vector<Bounce>, 3> queues;  // by Refl_t
+    paths.reserve(rays.size());
+    for (std::size_t i = 0; i < rays.size(); ++i) paths.push_back({rays[i], {1, 1, 1}, 1, i, streams[i]});
+
+    while (not paths.empty()) {
+        const auto hits = closest_hits(paths | ranges::views::transform(&Path::ray));
+        for (auto &queue : queues) queue.clear();
+        for (std::size_t i = 0; i < paths.size(); ++i) {
+            const auto [intersects, t, obj] = to_hit(hits[i].first, hits[i].second);
+            if (!intersects) continue;
+            auto path = paths[i];
+            result[path.sample] = result[path.sample] + path.throughput.mult(obj.e);
+            if (baked_scene.emission_only[hits[i].second]) continue;  // as radiance() ends it
+            auto f = obj.c;
+            if (path.depth > 5) {
+                const auto p = std::max({f.x, f.y, f.z});  // max refl
+                if (path.prng() >= p) continue;  // R.R.
+                f = f * (1 / p);
+            }
+            const auto& [o, d] = path.ray;
+            const auto x = o + d * t, n = (x - obj.p).norm(),
+                 nl = n.dot(d) < 0 ? n : n * -1;
+            path.throughput = path.throughput.mult(f);
+            queues[obj.refl].push_back({path, x, n, nl});
+        }
+
+        next.clear();
+        const auto bounce = [&](const Path &path, const Ray &ray, const auto weight, const Stream &prng) {
+            next.push_back({ray, path.throughput * weight, path.depth + 1, path.sample, prng});
+        };
+        for (auto &[path, x, n, nl] : queues[DIFF]) {  // Ideal DIFFUSE reflection
+            bounce(path, Ray{x, diffuse_direction(nl, path.prng)}, 1., path.prng);
+        }
+        for (auto &[path, x, n, nl] : queues[SPEC]) {  // Ideal SPECULAR reflection
+            bounce(path, Ray{x, reflect(path.ray.d, n)}, 1., path.prng);
+        }
+        for (auto &[path, x, n, nl] : queues[REFR]) {  // Ideal dielectric REFRACTION
+            const auto reflRay = Ray{x, reflect(path.ray.d, n)};
+            const auto glass = dielectric(path.ray.d, n, nl);
+            if (glass.total_internal_reflection) {
+                bounce(path, reflRay, 1., path.prng);
+            } else if (path.depth > 2) {  // Russian roulette
+                if (path.prng() < glass.P) {
+                    bounce(path, reflRay, glass.RP, path.prng);
+                } else {
+                    bounce(path, Ray{x, glass.tdir}, glass.TP, path.prng);
+                }
+            } else {  // splitting
+                bounce(path, reflRay, glass.Re, path.prng);
+                bounce(path, Ray{x, glass.tdir}, glass.Tr, path.prng.fork());
+            }
+        }
+        std::swap(paths, next);
+    }
+    return result;
+}
+
+//// light sampling ////
+
+/// the pdf per steradian of the directions from x that cone_direction() draws for light, 0
+/// from inside it
+inline constexpr auto cone_pdf(const Vec &x, const Sphere &light) {
+    const auto wc = light.p - x;
+    const auto sin2_max = light.rad * light.rad / wc.dot(wc);
+    if (sin2_max >= 1) return 0.;
+    // 1 - cos without the cancellation of small cones
+    return 1 / (2 * M_PI * (sin2_max / (1 + csqrt(1 - sin2_max))));
+}
+
+/// A direction from x at light, uniform over the cone of those that hit it, from the 2D
+/// sample u: solid angle sampling of a sphere (Shirley et al., "Monte Carlo techniques for
+/// direct lighting calculations", 1996).
+inline constexpr auto cone_direction(const Vec &x, const Sphere &light, const std::pair<double, double> u) {
+    const auto wc = light.p - x;
+    const auto sin2_max = light.rad * light.rad / wc.dot(wc);
+    const auto cos_theta = 1 - u.first * sin2_max / (1 + csqrt(1 - sin2_max)),
+        sin_theta = csqrt(std::max(0., 1 - cos_theta * cos_theta)), phi = 2 * M_PI * u.second;
+    const auto w = wc.norm(), u_ = ((fabs(w.x) > .1 ? Vec{0, 1} : Vec{1}) % w).norm(),
+        v = w % u_;
+    return (u_ * cos(phi) * sin_theta + v * sin(phi) * sin_theta + w * cos_theta).norm();
+}
+
+/// the weight of a sample by the strategy of pdf against another of pdf other, by the power
+/// heuristic of multiple importance sampling (Veach, 1997)
+inline constexpr auto power_heuristic(const double pdf, const double other) { return pdf * pdf / (pdf * pdf + other * other); }
+
+/// The light reaching x on a diffuse surface facing nl straight from one of the lights, the
+/// albedo left out: one picked at random and sampled by cone_direction(), weighed against
+/// the diffuse bounce finding it.
+inline constexpr auto direct_light(const Vec &x, const Vec &nl, auto &prng) {
+    constexpr auto lights = baked_scene.lights.size();
+    if constexpr (lights == 0) {
+        return Vec();
+    } else {
+        const auto pick = lights > 1 ? std::min(static_cast<std::size_t>(prng() * lights), lights - 1) : 0;
+        const auto index = baked_scene.lights[pick];
+        const auto &light = spheres[index];
+        const auto u = sample_2d(prng);
+        const auto pdf = cone_pdf(x, light) / lights;
+        if (pdf == 0) return Vec();
+        const auto d = cone_direction(x, light, u);
+        const auto cos_theta = d.dot(nl);
+        if (cos_theta <= 0) return Vec();
+        if (const auto [t, hit] = closest_hit(Ray{x, d}); t == inf || hit != index) return Vec();  // shadowed
+        const auto diffuse_pdf = cos_theta / M_PI;
+        return light.e * (diffuse_pdf / pdf * power_heuristic(pdf, diffuse_pdf));
+    }
+}
+
+/// where a ray left a diffuse surface, to weigh the light that it finds against direct_light()
+struct DiffuseBounce {
+    Vec x, nl;
+};
+
+/// Like radiance(), but next event estimation: at every diffuse hit the lights are sampled
+/// as well, by direct_light(), and the light found by the diffuse bounce is weighed against
+/// that. Light found after a camera ray or a specular bounce counts in full, as only the
+/// bounce could have found it.
+constexpr Vec radiance_next_event(const RayLike auto &r, auto &prng, const int depth = 1,
+                                  const std::optional<DiffuseBounce> &from = std::nullopt) {
+    const auto [t, index] = closest_hit(r);
+    const auto [intersects, _, obj] = to_hit(t, index);
+    if (!intersects) return Vec();  // if miss, return black
+    const auto& [o, d] = r;
+    const auto e = [&, index = index, &obj = obj] {
+        if (!from || std::find(baked_scene.lights.begin(), baked_scene.lights.end(), index) == baked_scene.lights.end()) return obj.e;
+        const auto light_pdf = cone_pdf(from->x, obj) / baked_scene.lights.size();
+        return obj.e * power_heuristic(d.dot(from->nl) / M_PI, light_pdf);
+    }();
+    if (baked_scene.emission_only[index]) return e;
+    const auto x = o + d * t, n = (x - obj.p).norm(),
+         nl = n.dot(d) < 0 ? n : n * -1;
+    auto f = obj.c;
+    if (depth > 5) {
+        const auto p = std::max({f.x, f.y, f.z});  // max refl
+        if (prng() >= p) return e;  // R.R.
+        f = f * (1 / p);
+    }
+    if (obj.refl == DIFF) {  // Ideal DIFFUSE reflection
+        const auto direct = direct_light(x, nl, prng);
+        const auto new_d = diffuse_direction(nl, prng);
+        return e + f.mult(direct + radiance_next_event(Ray{x, new_d}, prng, depth + 1, DiffuseBounce{x, nl}));
+    } else if (obj.refl == SPEC) {  // Ideal SPECULAR reflection
+        return e + f.mult(radiance_next_event(Ray{x, reflect(d, n)}, prng, depth + 1));
+    }
+    const auto reflRay = Ray{x, reflect(d, n)};  // Ideal dielectric REFRACTION
+    const auto glass = dielectric(d, n, nl);
+    if (glass.total_internal_reflection) {
+        return e + f.mult(radiance_next_event(reflRay, prng, depth + 1));
+    } else if (depth > 2) {  // Russian roulette
+        return e + f.mult(prng() < glass.P ? radiance_next_event(reflRay, prng, depth + 1) * glass.RP
+                                           : radiance_next_event(Ray{x, glass.tdir}, prng, depth + 1) * glass.TP);
+    }
+    auto transmitted = prng.fork();  // splitting
+    const auto reflected = radiance_next_event(reflRay, prng, depth + 1) * glass.Re;
+    return e + f.mult(reflected + radiance_next_event(Ray{x, glass.tdir}, transmitted, depth + 1) * glass.Tr);
+}
+
+/// how camera rays are intersected with the scene: one at a time, or a pixel's worth in
+/// packets of SIMD lanes. The packets draw all of a pixel's camera rays before tracing any
+/// of them, so they give a different, but just as likely, image.
+enum class Primary { single, packets };
+
+/// how paths are traced: by radiance() one at a time, by radiance_wavefront() for a batch
+/// of pixels at once, which intersects every bounce in packets where it can, or by
+/// radiance_next_event() one at a time, sampling the lights as well
+enum class Integrator { recursive, wavefront, next_event };
+
+/// where the samples come from: from a Philox stream, from Owen-scrambled Sobol points, or
+/// from Sobol points that neighbouring pixels shift by blue noise
+enum class Sampling { random, sobol, blue_noise };
+
+/// how create_image() renders, by default as smallpt always has
+struct RenderSettings {
+    Primary primary = Primary::single;  // for Integrator::recursive
+    Integrator integrator = Integrator::recursive;
+    Sampling sampling = Sampling::random;  // for each sample its own, but in create_image() not for Integrator::recursive
+};
+
+/// f(sampling) with sampling as a std::integral_constant, for a type of sampler each
+inline constexpr decltype(auto) with_sampling(const Sampling sampling, auto &&f) {
+    switch (sampling) {
+    case Sampling::sobol: return f(std::integral_constant<Sampling, Sampling::sobol>{});
+    case Sampling::blue_noise: return f(std::integral_constant<Sampling, Sampling::blue_noise>{});
+    default: return f(std::integral_constant<Sampling, Sampling::random>{});
+    }
+}
+
+/// about how many paths radiance_wavefront() is given at once, in whole pixels
+inline constexpr auto wavefront_paths = 4096;
+
+/// the camera looking into the box, for an image of width by height pixels
+struct Camera {
+    static constexpr auto o = Vec{50, 52, 295.6}, d = Vec{0, -0.042612, -1}.norm();  // cam pos, dir
+    int width, height;
+    Vec cx, cy;
+
+    constexpr Camera(const int width_, const int height_)
+        : width(width_), height(height_), cx{width_ * .5135 / height_}, cy((cx % d).norm() * .5135) {}
+
+    /// a ray through a random point of subpixel (sx, sy) of pixel (x, y), counting y from the bottom
+    constexpr auto ray(const int x, const int y, const int sx, const int sy, auto &prng) const {
+        const auto [u1, u2] = sample_2d(prng);
+        const auto r1 = 2 * u1,
+            dx = r1 < 1 ? csqrt(r1) - 1 : 1 - csqrt(2 - r1);
+        const auto r2 = 2 * u2,
+            dy = r2 < 1 ? csqrt(r2) - 1 : 1 - csqrt(2 - r2);
+        const auto dd = (cx * (((sx + .5 + dx) / 2 + x) / width - .5) +
+                cy * (((sy + .5 + dy) / 2 + y) / height - .5) +
+                d).norm();
+        return Ray{o + dd * 140, dd};  // Camera rays are pushed forward to start in interior
+    }
+
+    /// the stream of sample s of subpixel (sx, sy) of pixel (x, y), counting y from the bottom
+    constexpr auto stream(const int x, const int y, const int sx, const int sy, const int s) const {
+        return Philox{static_cast<std::uint64_t>(y * width + x), static_cast<std::uint64_t>((s * 2 + sy) * 2 + sx)};
+    }
+
+    /// the same from the sampler of sampling
+    template<Sampling sampling>
+    constexpr auto sampler(const int x, const int y, const int sx, const int sy, const int s) const {
+        const auto subpixel = static_cast<std::uint64_t>(sy * 2 + sx);
+        if constexpr (sampling == Sampling::sobol) {
+            return Sobol{static_cast<std::uint32_t>(s), mix(static_cast<std::uint64_t>(y * width + x) << 2 | subpixel)};
+        } else if constexpr (sampling == Sampling::blue_noise) {
+            return Sobol{static_cast<std::uint32_t>(s), mix(subpixel), x, y};
+        } else {
+            return stream(x, y, sx, sy, s);
+        }
+    }
+};
+
+/// the radiance along each of rays, each drawing from its own of streams, traced as settings say
+template<typename Stream>
+constexpr auto trace(const std::vector<Ray> &rays, std::vector<Stream> streams, const RenderSettings settings) {
+    if (settings.integrator == Integrator::wavefront) {
+        return radiance_wavefront(rays, std::move(streams));
+    }
+    std::vector<Vec> result;
+    result.reserve(rays.size());
+    if (settings.integrator == Integrator::next_event) {
+        for (std::size_t i = 0; i < rays.size(); ++i) result.push_back(radiance_next_event(rays[i], streams[i]));
+    } else if (settings.primary == Primary::packets) {
+        const auto hits = closest_hits(rays);
+        for (std::size_t i = 0; i < rays.size(); ++i) {
+            const auto [t, index] = hits[i];
+            result.push_back(radiance(rays[i], to_hit(t, index), streams[i]));
+        }
+    } else {
+        for (std::size_t i = 0; i < rays.size(); ++i) result.push_back(radiance(rays[i], streams[i]));
+    }
+    return result;
+}
+
+constexpr auto create_image(concepts::integral auto height, concepts::integral auto width, concepts::integral auto samples, const RenderSettings settings = {}) {
     namespace rv = ranges::views;
     // create a single row
     const auto create_row = [=](auto y){
         auto prng = rand48{static_cast<uint64_t>(y*y*y) << 32};
-        constexpr auto o = Vec{50, 52, 295.6}, d = Vec{0, -0.042612, -1}.norm();  // cam pos, dir
-        const auto cx = Vec{width * .5135 / height}, cy = (cx % d).norm() * .5135;
-        return rv::iota(0, width) | rv::transform([&](const auto x) { // Loop cols
+        const auto camera = Camera{static_cast<int>(width), static_cast<int>(height)};
+        const auto camera_ray = [&](const auto x, const auto sy, const auto sx) {
+            return camera.ray(x, y, sx, sy, prng);
+        };
+        // all camera rays of the pixels from begin to end, a pixel's subpixels and samples in order
+        const auto camera_rays = [&](const auto begin, const auto end) {
+            std::vector<Ray> rays;
+            rays.reserve(static_cast<std::size_t>((end - begin) * 4 * samples));
+            for (auto x = begin; x < end; ++x) {
+                for (auto sy = 0; sy < 2; ++sy) {
+                    for (auto sx = 0; sx < 2; ++sx) {
+                        for (auto s = 0; s < samples; ++s) rays.push_back(camera_ray(x, sy, sx));
+                    }
+                }
+            }
+            return rays;
+        };
+        // a pixel from the radiance of each sample(sy, sx, s) of its subpixels
+        const auto pixel = [=](const auto &sample) {
             return reduce(rv::iota(0, 2) | rv::transform([&](const auto sy) { // 2x2 subpixel rows
                 return reduce(rv::iota(0, 2) | rv::transform([&](const auto sx) { // 2x2 subpixel cols
                     const auto r = reduce(rv::iota(0, samples)
-                        | rv::transform([&, scale = 1. / samples](const auto) {
-                        const auto r1 = 2 * prng(),
-                            dx = r1 < 1 ? csqrt(r1) - 1 : 1 - csqrt(2 - r1);
-                        const auto r2 = 2 * prng(),
-                            dy = r2 < 1 ? csqrt(r2) - 1 : 1 - csqrt(2 - r2);
-                        const auto dd = (cx * (((sx + .5 + dx) / 2 + x) / width - .5) +
-                                cy * (((sy + .5 + dy) / 2 + y) / height - .5) +
-                                d).norm();
-                        return radiance(Ray{o + dd * 140, dd}, prng) * scale;
-                    }));  // Camera rays are pushed ^^^^^ forward to start in interior
+                        | rv::transform([&, scale = 1. / samples](const auto s) {
+                        return sample(sy, sx, s) * scale;
+                    }));
                     return Vec{clamp(r.x), clamp(r.y), clamp(r.z)} * .25;
                 }));
             }));
+        };
+        if (settings.integrator != Integrator::recursive) {
+            // each sample draws from its own sampler instead, as render_progressive() has them
+            const auto trace_pixels = [&](const auto begin, const auto end) {
+                return with_sampling(settings.sampling, [&](const auto sampling) {
+                    std::vector<Ray> rays;
+                    std::vector<decltype(camera.sampler<sampling()>(0, 0, 0, 0, 0))> streams;
+                    rays.reserve(static_cast<std::size_t>((end - begin) * 4 * samples));
+                    streams.reserve(rays.capacity());
+                    for (auto x = begin; x < end; ++x) {
+                        for (auto sy = 0; sy < 2; ++sy) {
+                            for (auto sx = 0; sx < 2; ++sx) {
+                                for (auto s = 0; s < samples; ++s) {
+                                    auto stream = camera.sampler<sampling()>(x, y, sx, sy, s);
+                                    rays.push_back(camera.ray(x, y, sx, sy, stream));
+                                    streams.push_back(stream);
+                                }
+                            }
+                        }
+                    }
+                    return trace(rays, std::move(streams), settings);
+                });
+            };
+            const auto batch_pixels = std::max(decltype(samples){1}, wavefront_paths / (4 * samples));
+            auto batch_begin = 0, batch_end = 0;
+            std::vector<Vec> batch;
+            return rv::iota(0, width) | rv::transform([&](const auto x) { // Loop cols
+                if (x == batch_end) {
+                    batch_begin = x;
+                    batch_end = static_cast<int>(std::min<decltype(x + batch_pixels)>(x + batch_pixels, width));
+                    batch = trace_pixels(batch_begin, batch_end);
+                }
+                return pixel([&](const auto sy, const auto sx, const auto s) {
+                    return batch[static_cast<std::size_t>(((x - batch_begin) * 4 + sy * 2 + sx) * samples + s)];
+                });
+            }) | ranges::to<std::vector>;
+        }
+        if (settings.primary == Primary::packets) {
+            return rv::iota(0, width) | rv::transform([&](const auto x) { // Loop cols
+                const auto rays = camera_rays(x, x + 1);
+                const auto hits = closest_hits(rays);
+                return pixel([&](const auto sy, const auto sx, const auto s) {
+                    const auto i = static_cast<std::size_t>((sy * 2 + sx) * samples + s);
+                    const auto [t, index] = hits[i];
+                    return radiance(rays[i], to_hit(t, index), prng);
+                });
+            }) | ranges::to<std::vector>;
+        }
+        return rv::iota(0, width) | rv::transform([&](const auto x) { // Loop cols
+            return pixel([&](const auto sy, const auto sx, const auto) {
+                return radiance(camera_ray(x, sy, sx), prng);
+            });
         }) | ranges::to<std::vector>;
     };
     
@@ -403,19 +1488,348 @@ constexpr auto create_image(concepts::integral auto height, concepts::integral a
 }
 
 #if __cpp_lib_constexpr_vector
-static_assert(test_result(create_image(2, 2, 1), {136, 136, 136, 0, 0, 0, 92, 12, 34, 0, 0, 0}}));
+static_assert(test_result(create_image(2, 2, 1), {136, 136, 136, 0, 0, 0, 92, 12, 34, 0, 0, 0}));
 #endif
 
+//// progressive rendering ////
+
+/// Calls task(index) for every index below count on thread_count threads. Each thread is
+/// dealt every thread_count-th index and takes them from the front of its deque. Once it
+/// runs out it steals from the back of the other deques, where the work dealt last sits.
+inline void for_each_stealing(const std::size_t count, const std::size_t thread_count, const auto &task) {
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::size_t> indices;
+    };
+    std::vector<Queue> queues(std::max<std::size_t>(1, thread_count));
+    for (std::size_t index = 0; index < count; ++index) {
+        queues[index % queues.size()].indices.push_back(index);
+    }
+
+    const auto next = [&](const std::size_t worker) -> std::optional<std::size_t> {
+        for (std::size_t offset = 0; offset < queues.size(); ++offset) {
+            auto &queue = queues[(worker + offset) % queues.size()];
+            const std::scoped_lock lock{queue.mutex};
+            if (queue.indices.empty()) continue;
+            const auto index = offset == 0 ? queue.indices.front() : queue.indices.back();
+            if (offset == 0) queue.indices.pop_front(); else queue.indices.pop_back();
+            return index;
+        }
+        return std::nullopt;
+    };
+    const auto work = [&](const std::size_t worker) {
+        while (const auto index = next(worker)) task(*index);
+    };
+
+    // the calling thread works along as worker 0
+    std::vector<std::jthread> threads;
+    for (std::size_t worker = 1; worker < queues.size(); ++worker) threads.emplace_back(work, worker);
+    work(0);
+}
+
+/// Sums of the radiance of every subpixel, one sample more each pass, and how the image
+/// of create_image() looks from them so far. Rows are counted from the top and gain their
+/// samples a band of them at a time.
+class Framebuffer {
+public:
+    static constexpr auto band_height = 32;
+
+    Framebuffer(const int width_, const int height_)
+        : width(width_), height(height_), sums(static_cast<std::size_t>(width_ * height_ * 4)),
+          band_passes(static_cast<std::size_t>((height_ + band_height - 1) / band_height)) {}
+
+    /// adds one sample of subpixel (sx, sy) of pixel (x, y)
+    void add(const int x, const int y, const int sx, const int sy, const Vec &radiance) {
+        auto &sum = sums[index(x, y, sx, sy)];
+        sum = sum + radiance;
+    }
+    /// the band has had a sample added to each of its subpixels
+    void finish_band(const int band) { ++band_passes[static_cast<std::size_t>(band)]; }
+    auto bands() const { return static_cast<int>(band_passes.size()); }
+    /// samples per subpixel that the whole image has
+    auto passes() const { return ranges::min(band_passes); }
+    /// samples per subpixel that row y has
+    auto passes(const int y) const { return band_passes[static_cast<std::size_t>(y / band_height)]; }
+
+    /// row y as create_image() gives it: the mean of each subpixel clamped, then of the four
+    auto row(const int y) const {
+        return pixels(y, [](const Vec &sub) { return Vec{clamp(sub.x), clamp(sub.y), clamp(sub.z)}; });
+    }
+    /// row y unclamped, for HDR images
+    auto radiance_row(const int y) const {
+        return pixels(y, [](const Vec &sub) { return sub; });
+    }
+    /// the pixels of every row()
+    auto image() const {
+        std::vector<Vec> pixels;
+        pixels.reserve(static_cast<std::size_t>(width * height));
+        for (auto y = 0; y < height; ++y) {
+            const auto r = row(y);
+            pixels.insert(pixels.end(), r.begin(), r.end());
+        }
+        return pixels;
+    }
+
+    const int width, height;
+
+private:
+    constexpr std::size_t index(const int x, const int y, const int sx, const int sy) const {
+        return static_cast<std::size_t>(((y * width + x) * 2 + sy) * 2 + sx);
+    }
+
+    std::vector<Vec> pixels(const int y, const auto &subpixel) const {
+        const auto scale = 1. / std::max(passes(y), 1);
+        std::vector<Vec> row;
+        row.reserve(static_cast<std::size_t>(width));
+        for (auto x = 0; x < width; ++x) {
+            const auto sub = [&](const int sx, const int sy) { return subpixel(sums[index(x, y, sx, sy)] * scale) * .25; };
+            row.push_back((sub(0, 0) + sub(1, 0)) + (sub(0, 1) + sub(1, 1)));
+        }
+        return row;
+    }
+
+    std::vector<Vec> sums;
+    std::vector<int> band_passes;
+};
+
+/// which passes render_progressive() renders: from first_pass on, until whichever comes
+/// first of those that are set
+struct Budget {
+    int passes = 0;                          // samples per subpixel
+    std::chrono::duration<double> time{};
+    int first_pass = 0;                      // the sample index of the first, for samples another render doesn't draw
+};
+
+/// Renders like create_image() one sample per subpixel at a time, for as many passes as
+/// budget allows. A pass is split into tiles of a band's height that the threads share by
+/// work stealing, the top ones dealt first. Each sample draws from a Camera::sampler() of
+/// its own, so the image after a number of passes is the same whichever threads rendered
+/// which tiles in whichever order, and however the tiles are cut.
+///
+/// on_rows(framebuffer, top, bottom, last) is called for rows top to bottom as soon as they
+/// have their sample of the pass, in order, from whichever thread finished them, and last
+/// tells if no pass follows. A time budget decides that at the start of a pass from how long
+/// the one before took, so it can be overrun by part of a pass, and takes two at least.
+/// on_pass(framebuffer) is called after each pass.
+inline auto render_progressive(const int height, const int width, const Budget budget, const RenderSettings settings,
+                               const auto &on_pass, const auto &on_rows,
+                               const std::size_t thread_count = std::max(1u, std::thread::hardware_concurrency())) {
+    constexpr auto tile_size = Framebuffer::band_height;
+    const auto camera = Camera{width, height};
+    Framebuffer framebuffer{width, height};
+    const auto tiles_x = (width + tile_size - 1) / tile_size, tiles_y = framebuffer.bands();
+
+    auto pass = 0;
+    auto last = false;
+    std::vector<std::atomic<int>> unfinished(static_cast<std::size_t>(tiles_y));  // tiles of each band
+    std::vector<bool> finished(static_cast<std::size_t>(tiles_y));
+    auto next_band = 0;
+    std::mutex bands_mutex;
+
+    const auto render_tile = [&](const std::size_t tile) {
+        const auto band = static_cast<int>(tile) / tiles_x;
+        const auto x0 = static_cast<int>(tile) % tiles_x * tile_size, y0 = band * tile_size;
+        const auto x1 = std::min(x0 + tile_size, width), y1 = std::min(y0 + tile_size, height);
+        const auto radiance = with_sampling(settings.sampling, [&](const auto sampling) {
+            std::vector<Ray> rays;
+            std::vector<decltype(camera.sampler<sampling()>(0, 0, 0, 0, 0))> streams;
+            rays.reserve(static_cast<std::size_t>((x1 - x0) * (y1 - y0) * 4));
+            streams.reserve(rays.capacity());
+            for (auto y = y0; y < y1; ++y) {
+                for (auto x = x0; x < x1; ++x) {
+                    for (auto sub = 0; sub < 4; ++sub) {
+                        // the camera counts rows from the bottom
+                        auto stream = camera.sampler<sampling()>(x, height - 1 - y, sub % 2, sub / 2, budget.first_pass + pass);
+                        rays.push_back(camera.ray(x, height - 1 - y, sub % 2, sub / 2, stream));
+                        streams.push_back(stream);
+                    }
+                }
+            }
+            return trace(rays, std::move(streams), settings);
+        });
+        auto sample = radiance.begin();
+        for (auto y = y0; y < y1; ++y) {
+            for (auto x = x0; x < x1; ++x) {
+                for (auto sub = 0; sub < 4; ++sub) framebuffer.add(x, y, sub % 2, sub / 2, *sample++);
+            }
+        }
+
+        if (unfinished[static_cast<std::size_t>(band)].fetch_sub(1) > 1) return;
+        const std::scoped_lock lock{bands_mutex};
+        finished[static_cast<std::size_t>(band)] = true;
+        for (; next_band < tiles_y && finished[static_cast<std::size_t>(next_band)]; ++next_band) {
+            framebuffer.finish_band(next_band);
+            on_rows(std::as_const(framebuffer), next_band * tile_size, std::min((next_band + 1) * tile_size, height), last);
+        }
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    auto last_pass = std::chrono::duration<double>{};
+    for (; not last; ++pass) {
+        const auto pass_start = std::chrono::steady_clock::now();
+        last = (budget.passes > 0 && pass + 1 >= budget.passes) ||
+               (budget.time > budget.time.zero() && pass > 0 && pass_start - start + 2 * last_pass > budget.time);
+        for (auto &tiles : unfinished) tiles = tiles_x;
+        std::fill(finished.begin(), finished.end(), false);
+        next_band = 0;
+        for_each_stealing(static_cast<std::size_t>(tiles_x * tiles_y), thread_count, render_tile);
+        last_pass = std::chrono::steady_clock::now() - pass_start;
+        on_pass(std::as_const(framebuffer));
+    }
+    return framebuffer;
+}
+
+//// output ////
+
+/// Writes rows of a Framebuffer to a binary PPM, or to a PFM of their unclamped radiance for
+/// HDR. Rows can come in any order. They are encoded straight away, then written at their
+/// place in the file by a thread of the writer's own while rendering goes on.
+class ImageWriter {
+public:
+    enum class Format { ppm, pfm };
+
+    ImageWriter(const std::string &path, const Format format_, const int width_, const int height_)
+        : format(format_), width(width_), height(height_), file(path, std::ios::binary),
+          header(format == Format::ppm ? fmt::format("P6\n{} {}\n255\n", width, height)
+                                       // a negative scale says little endian
+                                       : fmt::format("PF\n{} {}\n{}\n", width, height, std::endian::native == std::endian::little ? "-1.0" : "1.0")) {
+        file.write(header.data(), static_cast<std::streamsize>(header.size()));
+        writer = std::jthread{[this](const std::stop_token stop) { write_chunks(stop); }};
+    }
+
+    /// row y of framebuffer, counting from the top
+    void write(const Framebuffer &framebuffer, const int y) {
+        std::vector<char> bytes;
+        if (format == Format::ppm) {
+            bytes.reserve(static_cast<std::size_t>(width * 3));
+            for (const auto &p : framebuffer.row(y)) {
+                for (const auto channel : {p.x, p.y, p.z}) bytes.push_back(static_cast<char>(toInt(channel)));
+            }
+        } else {
+            bytes.reserve(static_cast<std::size_t>(width * 3) * sizeof(float));
+            for (const auto &p : framebuffer.radiance_row(y)) {
+                for (const auto channel : {p.x, p.y, p.z}) {
+                    const auto value = std::bit_cast<std::array<char, sizeof(float)>>(static_cast<float>(channel));
+                    bytes.insert(bytes.end(), value.begin(), value.end());
+                }
+            }
+        }
+        // PFM goes from the bottom row up
+        const auto row = format == Format::ppm ? y : height - 1 - y;
+        const auto offset = header.size() + static_cast<std::size_t>(row) * bytes.size();
+        {
+            const std::scoped_lock lock{mutex};
+            chunks.push_back({offset, std::move(bytes)});
+        }
+        ready.notify_one();
+    }
+
+private:
+    struct Chunk {
+        std::size_t offset;
+        std::vector<char> bytes;
+    };
+
+    /// until told to stop and there's nothing left to write
+    void write_chunks(const std::stop_token stop) {
+        std::unique_lock lock{mutex};
+        while (ready.wait(lock, stop, [&] { return not chunks.empty(); })) {
+            const auto chunk = std::move(chunks.front());
+            chunks.pop_front();
+            lock.unlock();
+            file.seekp(static_cast<std::streamoff>(chunk.offset));
+            file.write(chunk.bytes.data(), static_cast<std::streamsize>(chunk.bytes.size()));
+            lock.lock();
+        }
+    }
+
+    const Format format;
+    const int width, height;
+    std::ofstream file;
+    const std::string header;
+    std::mutex mutex;
+    std::condition_variable_any ready;
+    std::deque<Chunk> chunks;
+    std::jthread writer;  // last, to be joined before the rest goes
+};
+
+// define SMALLPT_NO_MAIN to include this file in the benchmarks
+#ifndef SMALLPT_NO_MAIN
+/// the whole of text as a number, if it is one
+template<typename T>
+std::optional<T> parse_number(const std::string_view text) {
+    auto value = T{};
+    const auto end = text.data() + text.size();
+    if (const auto [last, error] = std::from_chars(text.data(), end, value); error != std::errc{} || last != end) return std::nullopt;
+    return value;
+}
+
+void print_usage(const char *name) {
+    fmt::print(std::cerr, "Usage: {} [samples] [--time <seconds>] [--every <passes>] [--pfm] [--sobol | --blue-noise] [--next-event]\n", name);
+}
+
 int main(int argc, char *argv[]) {
+    constexpr auto h = 768, w = 1024;
+    auto budget = Budget{};
+    auto every = 0;  // passes between intermediate images
+    auto format = ImageWriter::Format::ppm;
+    auto sampling = Sampling::random;
+    auto integrator = Integrator::wavefront;
+    for (auto arg = 1; arg < argc; ++arg) {
+        const auto option = std::string_view{argv[arg]};
+        // reads the number after the option, false if there is none or it is no number
+        const auto value = [&](auto &into) {
+            const auto number = arg + 1 < argc ? parse_number<std::remove_reference_t<decltype(into)>>(argv[++arg]) : std::nullopt;
+            if (number) into = *number;
+            return number.has_value();
+        };
+        auto valid = true;
+        if (option == "--time") {
+            auto seconds = 0.;
+            valid = value(seconds);
+            budget.time = std::chrono::duration<double>{seconds};
+        } else if (option == "--every") {
+            valid = value(every);
+        } else if (option == "--pfm") {
+            format = ImageWriter::Format::pfm;
+        } else if (option == "--sobol") {
+            sampling = Sampling::sobol;
+        } else if (option == "--blue-noise") {
+            sampling = Sampling::blue_noise;
+        } else if (option == "--next-event") {
+            integrator = Integrator::next_event;
+        } else if (const auto samples = parse_number<int>(option)) {
+            budget.passes = std::max(1, *samples / 4);  // # samples
+        } else {
+            valid = false;
+        }
+        // a typo shouldn't quietly render with the defaults
+        if (!valid) {
+            fmt::print(std::cerr, "Unknown option, or one without its number: {}\n", option);
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (budget.passes == 0 && budget.time == budget.time.zero()) budget.passes = 1;
+
     // sanity checks
 #ifndef __clang__
     assert(test_result(create_image(2, 2, 1), {136, 136, 136, 0, 0, 0, 92, 12, 34, 0, 0, 0}));
     assert(test_result(create_image(3, 3, 1), {186, 186, 186, 136, 136, 136, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 136, 136, 136}));
 #endif
-    
-    constexpr auto h = 768, w = 1024;
-    const auto samps = argc == 2 ? atoi(argv[1]) / 4 : 1;  // # samples
-    const auto c = create_image(h, w, samps);
-    std::ofstream f{"image.ppm"};  // Write image to PPM file.
-    fmt::print(f, "P3\n{} {}\n{}\n{} ", w, h, 255, fmt::join(c, " "));
+
+    // Write image to PPM file, or PFM, a band of rows at a time as soon as they're done
+    const auto path = format == ImageWriter::Format::ppm ? "image.ppm" : "image.pfm";
+    std::optional<ImageWriter> file;
+    const auto start = std::chrono::steady_clock::now();
+    render_progressive(h, w, budget, {.integrator = integrator, .sampling = sampling}, [&](const Framebuffer &fb) {
+        fmt::print(std::cerr, "\rRendering ({} spp) {:.1f}s", fb.passes() * 4,
+                std::chrono::duration<double>{std::chrono::steady_clock::now() - start}.count());
+    }, [&](const Framebuffer &fb, const int top, const int bottom, const bool last) {
+        if (not last && (every <= 0 || fb.passes(top) % every != 0)) return;
+        if (top == 0) file.emplace(path, format, w, h);
+        for (auto y = top; y < bottom; ++y) file->write(fb, y);
+        if (bottom == h) file.reset();
+    });
 }
+#endif
@@ -0,0 +1,97 @@
+#ifndef CPP_WEEKLY_DOUBLE_DOUBLE_HPP
+#define CPP_WEEKLY_DOUBLE_DOUBLE_HPP
+
+#include <cmath>
+#include <type_traits>
+
+// The unevaluated sum hi + lo of two doubles, with |lo| at most half an ulp of hi, which
+// makes for about 106 bits of mantissa at a few times the cost of plain double. T is
+// double, or a SIMD vector of doubles so that every lane carries one number.
+//
+// Only what the Mandelbrot kernels need: +, -, * and abs(), each accurate to a few units
+// in the last place of the 106 bits (Dekker, Knuth; see also the QD library).
+template<typename T> struct DoubleDouble
+{
+  T hi{};
+  T lo{};
+};
+
+namespace double_double_detail {
+
+// a + b exactly, as the rounded sum and the error of rounding it
+template<typename T> constexpr DoubleDouble<T> two_sum(const T a, const T b) noexcept
+{
+  const T sum    = a + b;
+  const T b_part = sum - a;
+  return { sum, (a - (sum - b_part)) + (b - b_part) };
+}
+
+// the same, for |a| >= |b|
+template<typename T> constexpr DoubleDouble<T> quick_two_sum(const T a, const T b) noexcept
+{
+  const T sum = a + b;
+  return { sum, b - (sum - a) };
+}
+
+// a * b exactly
+template<typename T> constexpr DoubleDouble<T> two_prod(const T a, const T b) noexcept
+{
+  const T product = a * b;
+#if defined(__FMA__)
+  // only for plain doubles, std::experimental::simd does its fma one lane at a time
+  if constexpr (std::is_floating_point_v<T>) { return { product, std::fma(a, b, -product) }; }
+#endif
+  // Dekker: split both into halves of 26 bits, whose products are exact
+  const auto split = [](const T value) {
+    const T scaled = value * T(134217729.0);// 2^27 + 1
+    const T high   = scaled - (scaled - value);
+    return DoubleDouble<T>{ high, value - high };
+  };
+  const auto [a_hi, a_lo] = split(a);
+  const auto [b_hi, b_lo] = split(b);
+  return { product, ((a_hi * b_hi - product) + a_hi * b_lo + a_lo * b_hi) + a_lo * b_lo };
+}
+
+}// namespace double_double_detail
+
+template<typename T> constexpr DoubleDouble<T> operator+(const DoubleDouble<T> &lhs, const DoubleDouble<T> &rhs) noexcept
+{
+  const auto [sum, error] = double_double_detail::two_sum(lhs.hi, rhs.hi);
+  return double_double_detail::quick_two_sum(sum, error + (lhs.lo + rhs.lo));
+}
+
+template<typename T> constexpr DoubleDouble<T> operator+(const DoubleDouble<T> &lhs, const T rhs) noexcept
+{
+  const auto [sum, error] = double_double_detail::two_sum(lhs.hi, rhs);
+  return double_double_detail::quick_two_sum(sum, error + lhs.lo);
+}
+
+template<typename T> constexpr DoubleDouble<T> operator-(const DoubleDouble<T> &value) noexcept { return { -value.hi, -value.lo }; }
+
+template<typename T> constexpr DoubleDouble<T> operator-(const DoubleDouble<T> &lhs, const DoubleDouble<T> &rhs) noexcept { return lhs + -rhs; }
+
+template<typename T> constexpr DoubleDouble<T> operator*(const DoubleDouble<T> &lhs, const DoubleDouble<T> &rhs) noexcept
+{
+  const auto [product, error] = double_double_detail::two_prod(lhs.hi, rhs.hi);
+  return double_double_detail::quick_two_sum(product, error + (lhs.hi * rhs.lo + lhs.lo * rhs.hi));
+}
+
+// only exact for powers of two, which is all it is meant for
+template<typename T> constexpr DoubleDouble<T> operator*(const DoubleDouble<T> &lhs, const double rhs) noexcept { return { lhs.hi * T(rhs), lhs.lo * T(rhs) }; }
+
+template<typename T> constexpr DoubleDouble<T> abs(const DoubleDouble<T> &value) noexcept
+{
+  if constexpr (std::is_floating_point_v<T>) {
+    return value.hi < 0.0 ? -value : value;
+  } else {
+    auto result                = value;
+    const auto negative        = value.hi < T(0.0);
+    where(negative, result.hi) = -value.hi;
+    where(negative, result.lo) = -value.lo;
+    return result;
+  }
+}
+
+static_assert((DoubleDouble<double>{ 1.0, 0x1p-60 } + DoubleDouble<double>{ -1.0, 0x1p-61 }).hi == 0x1.8p-60);
+
+#endif
@@ -0,0 +1,203 @@
+#ifndef CPP_WEEKLY_FIXED_POINT_HPP
+#define CPP_WEEKLY_FIXED_POINT_HPP
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+// Sign and magnitude fixed point number with one 64 bit limb for the integer part and
+// Limbs - 1 limbs of fraction, so FixedPoint<8> resolves down to 2^-448 (about 1e-135).
+// Slow compared to double, but only ever used for the handful of values that need it,
+// like the center of a deep zoom and its reference orbit.
+template<std::size_t Limbs> class FixedPoint
+{
+  static_assert(Limbs >= 2);
+
+public:
+  constexpr FixedPoint() noexcept = default;
+
+  // exact, as long as the integer part of the value fits into 64 bits
+  constexpr explicit FixedPoint(const double value) noexcept
+  {
+    negative       = value < 0;
+    auto magnitude = negative ? -value : value;
+
+    limbs[Limbs - 1] = static_cast<std::uint64_t>(magnitude);
+    magnitude -= static_cast<double>(limbs[Limbs - 1]);
+
+    // multiplying by a power of two and taking off the integer part are both exact
+    for (auto limb = Limbs - 1; limb-- > 0;) {
+      magnitude *= 0x1p64;
+      limbs[limb] = static_cast<std::uint64_t>(magnitude);
+      magnitude -= static_cast<double>(limbs[limb]);
+    }
+
+    normalize();
+  }
+
+  // parses [+-]digits[.digits], throws std::invalid_argument for anything else
+  static constexpr FixedPoint from_string(const std::string_view text)
+  {
+    auto remaining = text;
+    bool negative_ = false;
+    if (!remaining.empty() && (remaining.front() == '-' || remaining.front() == '+')) {
+      negative_ = remaining.front() == '-';
+      remaining.remove_prefix(1);
+    }
+
+    const auto point    = remaining.find('.');
+    const auto whole    = remaining.substr(0, point);
+    const auto fraction = point == std::string_view::npos ? std::string_view{} : remaining.substr(point + 1);
+
+    const auto digit = [&](const char c) -> std::uint64_t {
+      if (c < '0' || c > '9') { throw std::invalid_argument("not a number: " + std::string{ text }); }
+      return static_cast<std::uint64_t>(c - '0');
+    };
+
+    if (whole.empty() && fraction.empty()) { throw std::invalid_argument("not a number: " + std::string{ text }); }
+    if (whole.size() > 18) { throw std::invalid_argument("integer part too large: " + std::string{ text }); }
+
+    // the fraction is built from the last digit back: f = (f + digit) / 10
+    FixedPoint result;
+    for (auto itr = fraction.rbegin(); itr != fraction.rend(); ++itr) {
+      result.limbs[Limbs - 1] += digit(*itr);
+      result.divide_magnitude(10);
+    }
+
+    for (const auto c : whole) { result.limbs[Limbs - 1] = result.limbs[Limbs - 1] * 10 + digit(c); }
+
+    result.negative = negative_;
+    result.normalize();
+    return result;
+  }
+
+  [[nodiscard]] constexpr double to_double() const noexcept
+  {
+    double result = 0.0;
+    double weight = 1.0;
+    for (auto limb = Limbs; limb-- > 0;) {
+      result += static_cast<double>(limbs[limb]) * weight;
+      weight *= 0x1p-64;
+    }
+    return negative ? -result : result;
+  }
+
+  constexpr FixedPoint operator-() const noexcept
+  {
+    auto result     = *this;
+    result.negative = !negative;
+    result.normalize();
+    return result;
+  }
+
+  friend constexpr FixedPoint operator+(const FixedPoint &lhs, const FixedPoint &rhs) noexcept
+  {
+    if (lhs.negative == rhs.negative) { return FixedPoint{ lhs.negative, add_magnitudes(lhs.limbs, rhs.limbs) }; }
+
+    if (compare_magnitudes(lhs.limbs, rhs.limbs) >= 0) {
+      return FixedPoint{ lhs.negative, subtract_magnitudes(lhs.limbs, rhs.limbs) };
+    } else {
+      return FixedPoint{ rhs.negative, subtract_magnitudes(rhs.limbs, lhs.limbs) };
+    }
+  }
+
+  friend constexpr FixedPoint operator-(const FixedPoint &lhs, const FixedPoint &rhs) noexcept { return lhs + -rhs; }
+
+  // truncates whatever falls below the last limb
+  friend constexpr FixedPoint operator*(const FixedPoint &lhs, const FixedPoint &rhs) noexcept
+  {
+    std::array<std::uint64_t, 2 * Limbs> product{};
+    for (std::size_t i = 0; i < Limbs; ++i) {
+      std::uint64_t carry = 0;
+      for (std::size_t j = 0; j < Limbs; ++j) {
+        const auto value = static_cast<unsigned __int128>(lhs.limbs[i]) * rhs.limbs[j] + product[i + j] + carry;
+        product[i + j]   = static_cast<std::uint64_t>(value);
+        carry            = static_cast<std::uint64_t>(value >> 64);
+      }
+      product[i + Limbs] = carry;
+    }
+
+    // product limb k has the weight 2^(64 * (k - 2 * (Limbs - 1)))
+    std::array<std::uint64_t, Limbs> magnitude{};
+    for (std::size_t limb = 0; limb < Limbs; ++limb) { magnitude[limb] = product[limb + Limbs - 1]; }
+    return FixedPoint{ lhs.negative != rhs.negative, magnitude };
+  }
+
+  constexpr FixedPoint &operator+=(const FixedPoint &rhs) noexcept { return *this = *this + rhs; }
+  constexpr FixedPoint &operator-=(const FixedPoint &rhs) noexcept { return *this = *this - rhs; }
+  constexpr FixedPoint &operator*=(const FixedPoint &rhs) noexcept { return *this = *this * rhs; }
+
+  constexpr bool operator==(const FixedPoint &) const noexcept = default;
+
+private:
+  using Magnitude = std::array<std::uint64_t, Limbs>;
+
+  constexpr FixedPoint(const bool negative_, const Magnitude &limbs_) noexcept : negative{ negative_ }, limbs{ limbs_ } { normalize(); }
+
+  // there is only one zero
+  constexpr void normalize() noexcept
+  {
+    if (negative) {
+      for (const auto limb : limbs) {
+        if (limb != 0) { return; }
+      }
+      negative = false;
+    }
+  }
+
+  constexpr void divide_magnitude(const std::uint64_t divisor) noexcept
+  {
+    unsigned __int128 remainder = 0;
+    for (auto limb = Limbs; limb-- > 0;) {
+      const auto value = (remainder << 64) | limbs[limb];
+      limbs[limb]      = static_cast<std::uint64_t>(value / divisor);
+      remainder        = value % divisor;
+    }
+  }
+
+  static constexpr int compare_magnitudes(const Magnitude &lhs, const Magnitude &rhs) noexcept
+  {
+    for (auto limb = Limbs; limb-- > 0;) {
+      if (lhs[limb] != rhs[limb]) { return lhs[limb] < rhs[limb] ? -1 : 1; }
+    }
+    return 0;
+  }
+
+  static constexpr Magnitude add_magnitudes(const Magnitude &lhs, const Magnitude &rhs) noexcept
+  {
+    Magnitude result{};
+    std::uint64_t carry = 0;
+    for (std::size_t limb = 0; limb < Limbs; ++limb) {
+      const auto value = static_cast<unsigned __int128>(lhs[limb]) + rhs[limb] + carry;
+      result[limb]     = static_cast<std::uint64_t>(value);
+      carry            = static_cast<std::uint64_t>(value >> 64);
+    }
+    return result;
+  }
+
+  // lhs must not be smaller than rhs
+  static constexpr Magnitude subtract_magnitudes(const Magnitude &lhs, const Magnitude &rhs) noexcept
+  {
+    Magnitude result{};
+    std::uint64_t borrow = 0;
+    for (std::size_t limb = 0; limb < Limbs; ++limb) {
+      const auto subtrahend = static_cast<unsigned __int128>(rhs[limb]) + borrow;
+      borrow                = lhs[limb] < subtrahend ? 1 : 0;
+      result[limb]          = static_cast<std::uint64_t>((static_cast<unsigned __int128>(borrow) << 64) + lhs[limb] - subtrahend);
+    }
+    return result;
+  }
+
+  bool negative = false;
+  // little endian, limbs[Limbs - 1] is the integer part
+  Magnitude limbs{};
+};
+
+static_assert(FixedPoint<4>{ 0.75 } + FixedPoint<4>{ -1.25 } == FixedPoint<4>{ -0.5 });
+static_assert(FixedPoint<4>{ -1.5 } * FixedPoint<4>{ 2.25 } == FixedPoint<4>{ -3.375 });
+static_assert(FixedPoint<4>{ 0.001643721971153 }.to_double() == 0.001643721971153);
+static_assert(FixedPoint<4>::from_string("-2.5") == FixedPoint<4>{ -2.5 });
+
+#endif
@@ -0,0 +1 @@
+g++ mandelbrot_bench.cpp -o mandelbrot_bench -std=c++2a -Wall -Wextra -pthread -O3 -march=native -ffp-contract=off -DNDEBUG -lbenchmark
@@ -0,0 +1 @@
+g++ mandelbrot_cli.cpp -o mandelbrot_cli -std=c++2a -Wall -Wextra -pthread -O3 -march=native -ffp-contract=off
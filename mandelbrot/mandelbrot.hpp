@@ -0,0 +1,1880 @@
+#ifndef CPP_WEEKLY_MANDELBROT_HPP
+#define CPP_WEEKLY_MANDELBROT_HPP
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <list>
+#include <thread>
+#include <future>
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include <span>
+#include <complex>
+#include <cassert>
+#include <numbers>
+#include <numeric>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "double_double.hpp"
+#include "fixed_point.hpp"
+
+#if __has_include(<experimental/simd>)
+#include <experimental/simd>
+#define MANDELBROT_HAS_SIMD 1
+namespace stdx = std::experimental;
+#else
+#define MANDELBROT_HAS_SIMD 0
+#endif
+
+constexpr std::size_t max_max_iterations      = 2000;
+constexpr std::size_t max_iteration_increment = 200;
+constexpr std::size_t start_max_iterations    = 400;
+
+template<typename T> struct Point
+{
+  T x{};
+  T y{};
+  constexpr bool operator!=(const Point &p) const = default;
+  constexpr bool operator==(const Point &p) const = default;
+};
+
+template<typename T> Point(T x, T y) -> Point<T>;
+
+// enough to zoom in to about 1e-130
+using Coordinate = FixedPoint<8>;
+
+// Ways of not iterating pixels that are in the set all the way to max_iteration. They are
+// only taken where they are valid, and each can be turned off to measure what it buys.
+struct Shortcuts
+{
+  // closed form tests for the main cardioid and the period 2 bulb
+  bool interior_checks = true;
+  // stop as soon as an orbit is caught in a cycle (Brent's algorithm)
+  bool periodicity = true;
+  // fill rectangles whose border is entirely in the set without iterating the inside
+  bool mariani_silver = true;
+
+  constexpr bool operator==(const Shortcuts &) const = default;
+};
+
+// What the orbits are computed in, from the cheapest to the one that zooms in the furthest.
+// automatic picks the cheapest one that still resolves the view (see select_precision).
+enum class Precision { automatic, single, double_precision, double_double, perturbation };
+
+struct Settings
+{
+  Point<Coordinate> center{ Coordinate{ 0.001643721971153 }, Coordinate{ -0.822467633298876 } };
+  double scale                   = 3.0;
+  double power                   = 2.0;
+  double do_abs                  = false;
+  std::size_t cur_max_iterations = start_max_iterations;
+  bool canceling                 = false;
+  Shortcuts shortcuts{};
+  Precision precision            = Precision::automatic;
+
+  constexpr bool operator!=(const Settings &) const = default;
+  constexpr bool operator==(const Settings &) const = default;
+
+  // the center rounded to double, which is all that single and double precision need
+  [[nodiscard]] constexpr Point<double> approximate_center() const noexcept { return { center.x.to_double(), center.y.to_double() }; }
+
+  // the center as the nearest double plus what's left over, for double-double precision
+  [[nodiscard]] constexpr Point<DoubleDouble<double>> double_double_center() const noexcept
+  {
+    const auto split = [](const Coordinate &value) {
+      const auto hi = value.to_double();
+      return DoubleDouble<double>{ hi, (value - Coordinate{ hi }).to_double() };
+    };
+    return { split(center.x), split(center.y) };
+  }
+};
+
+struct Size
+{
+  unsigned int width{};
+  unsigned int height{};
+};
+
+struct SizeIterator
+{
+  Size size;
+  std::pair<std::size_t, std::size_t> loc{ 0, 0 };
+
+
+  constexpr SizeIterator &operator++() noexcept
+  {
+    ++loc.first;
+    if (loc.first >= size.width) {
+      loc.first = 0;
+      ++loc.second;
+    }
+    return *this;
+  }
+
+  constexpr SizeIterator operator++(int) noexcept
+  {
+    const auto prev = *this;
+    ++(*this);
+    return prev;
+  }
+
+
+  [[nodiscard]] constexpr bool operator!=(const SizeIterator &other) const noexcept { return loc != other.loc; }
+
+  [[nodiscard]] constexpr const std::pair<std::size_t, std::size_t> &operator*() const noexcept { return loc; }
+  [[nodiscard]] constexpr std::pair<std::size_t, std::size_t> &operator*() noexcept { return loc; }
+};
+
+[[nodiscard]] constexpr SizeIterator begin(const Size &t_s) noexcept
+{
+  return SizeIterator{ t_s };
+}
+
+[[nodiscard]] constexpr SizeIterator end(const Size &t_s) noexcept
+{
+  return SizeIterator{ t_s, { 0, t_s.height } };
+}
+
+
+template<typename T> struct Color
+{
+  T r{};
+  T g{};
+  T b{};
+};
+
+template<typename T> Color(T r, T g, T b) -> Color<T>;
+
+template<typename T> constexpr std::uint8_t to_8bit(const T t_component) noexcept
+{
+  return static_cast<std::uint8_t>(std::floor(t_component * 255));
+}
+
+// a pixel as it goes to the screen, in the byte order sf::Texture::update() takes
+struct Rgba8
+{
+  std::uint8_t r{};
+  std::uint8_t g{};
+  std::uint8_t b{};
+  std::uint8_t a{ 255 };
+
+  constexpr bool operator==(const Rgba8 &) const = default;
+};
+
+static_assert(sizeof(Rgba8) == 4);
+
+template<typename T> constexpr Rgba8 to_rgba8(const Color<T> &t_color) noexcept
+{
+  return { to_8bit(t_color.r), to_8bit(t_color.g), to_8bit(t_color.b) };
+}
+
+// Natural log from the exponent bits and a polynomial on the mantissa, good to about 4e-7,
+// which is plenty for picking one of 256 shades. Only for positive, normal, finite values,
+// and without a branch, so that loops over it vectorize.
+[[nodiscard]] constexpr double fast_log(const double value) noexcept
+{
+  // split into 2^exponent * m with m in [sqrt(1/2), sqrt(2)), without a branch: offsetting
+  // the bits by those of sqrt(1/2) carries into the exponent exactly when m >= sqrt(2)
+  const auto bits     = std::bit_cast<std::int64_t>(value);
+  const auto offset   = bits - std::bit_cast<std::int64_t>(std::numbers::sqrt2 / 2.0);
+  const auto exponent = offset >> 52;
+  const auto t        = std::bit_cast<double>(bits - (exponent << 52)) - 1.0;
+
+  // log(1 + t) / t, fitted on Chebyshev nodes over the range of t
+  const auto log_m = t
+                     * (1.0000009643975838
+                        + t
+                            * (-0.5000114503774582
+                               + t * (0.33314673808550244 + t * (-0.2490828918473733 + t * (0.2049175965003972 + t * (-0.1868075142692594 + t * 0.11931054435252003))))));
+  return static_cast<double>(exponent) * std::numbers::ln2 + log_m;
+}
+
+static_assert(fast_log(1.0) == 0.0);
+static_assert(std::abs(fast_log(1e300) - 690.77552789821368) < 1e-6);
+
+template<std::size_t Power, typename Value> constexpr auto pow(Value t_val)
+{
+  auto result = t_val;
+  for (std::size_t itr = 1; itr < Power; ++itr) { result *= t_val; }
+  return result;
+}
+
+template<typename ComplexType, typename PowerType> constexpr auto opt_pow(const std::complex<ComplexType> &t_val, PowerType t_power)
+{
+  if (t_power == static_cast<PowerType>(1.0)) {
+    return t_val;
+  } else if (t_power == static_cast<PowerType>(2.0)) {
+    return std::complex{ pow<2>(std::real(t_val)) - pow<2>(std::imag(t_val)), 2 * std::real(t_val) * std::imag(t_val) };
+  } else if (t_power == static_cast<decltype(t_power)>(3.0)) {
+    const auto a = std::real(t_val);
+    const auto b = std::imag(t_val);
+    return std::complex{ -3 * a * pow<2>(b) + pow<3>(a), 3 * pow<2>(a) * b - pow<3>(b) };
+    //  } else if (t_power == static_cast<decltype(t_power)>(4.0)) {
+    //    const auto a = std::real(t_val);
+    //    const auto b = std::imag(t_val);
+    //    return std::complex{ pow<4>(a) + pow<4>(b) - 6 * pow<2>(a) * pow<2>(b), 4 * pow<3>(a) * b - 4 * a * pow<3>(b) };
+  } else {
+    return std::pow(t_val, t_power);
+  }
+}
+
+// where the orbit of a point has got to: how many iterations so far, the current value and
+// the iteration it is going to stop at (max_iteration, or 5 past escaping for smooth coloring)
+template<typename T> struct Orbit
+{
+  std::size_t iteration{};
+  std::complex<T> current{};
+  std::size_t stop_iteration{};
+  bool escaped{};
+};
+
+template<typename T> constexpr auto start_orbit(const std::complex<T> scaled, const std::size_t max_iteration) noexcept
+{
+  return Orbit<T>{ 0, scaled, max_iteration, false };
+}
+
+// the renderer keeps every orbit as Orbit<double>, whatever it is iterated in
+template<typename To, typename From> constexpr Orbit<To> orbit_cast(const Orbit<From> &orbit) noexcept
+{
+  return Orbit<To>{ orbit.iteration, std::complex<To>(orbit.current), orbit.stop_iteration, orbit.escaped };
+}
+
+// How close an orbit has to come back to an earlier value to count as a cycle, as
+// |dx| + |dy|. Not squared: converging orbits get close enough that the square of the
+// difference is a denormal, and those are slow enough to lose everything the check saves.
+constexpr double periodicity_tolerance = 1e-13;
+// Only compare every this many iterations. In the SIMD kernel the comparison feeds straight
+// back into which lanes keep running, which nearly doubles the time per iteration if it's
+// done every time. Checking at multiples of this since the last save still finds every
+// cycle length, just a little later.
+constexpr std::size_t periodicity_check_interval = 16;
+
+// Continues an orbit until it stops. One that hasn't escaped can be carried on later with a
+// larger max_iteration (see raise_max_iteration), and ends up in the same place as if it had
+// been started with that max_iteration in the first place.
+//
+// With periodicity on, an orbit that comes back to where it was is in the set and stops
+// right there, as if it had made it to max_iteration. Brent's algorithm: compare against a
+// saved value that is moved up after 1, 2, 4, 8, ... iterations, which finds any cycle
+// length without having to keep more than the one value around.
+template<typename T, typename PowerType>
+constexpr void iterate(Orbit<T> &orbit, const std::complex<T> scaled, const PowerType power, const bool do_abs, const bool periodicity = false) noexcept
+{
+  auto &[iteration, current, stop_iteration, escaped] = orbit;
+
+  auto saved                 = current;
+  std::size_t since_saved    = 0;
+  std::size_t saved_interval = 1;
+
+  while (iteration < stop_iteration) {
+    if (std::norm(current) > (2.0 * 2.0) && !escaped) {
+      stop_iteration = iteration + 5;
+      escaped        = true;
+    }
+
+    if (do_abs) { current = std::complex{ std::abs(std::real(current)), std::abs(std::imag(current)) }; }
+
+    current = opt_pow(current, power);
+    current += scaled;
+
+    ++iteration;
+
+    if (periodicity && !escaped) {
+      ++since_saved;
+      if (since_saved % periodicity_check_interval == 0
+          && std::abs(std::real(current) - std::real(saved)) + std::abs(std::imag(current) - std::imag(saved)) < periodicity_tolerance) {
+        iteration = stop_iteration;
+      } else if (since_saved == saved_interval) {
+        saved = current;
+        since_saved = 0;
+        saved_interval *= 2;
+      }
+    }
+  }
+}
+
+// closed form tests for the two biggest components of the set, only valid for z^2 + c
+[[nodiscard]] constexpr bool in_cardioid_or_bulb(const std::complex<double> c) noexcept
+{
+  const auto x = std::real(c) - 0.25;
+  const auto y = std::imag(c);
+  const auto q = x * x + y * y;
+  if (q * (q + x) <= 0.25 * y * y) { return true; }
+
+  const auto bulb_x = std::real(c) + 1.0;
+  return bulb_x * bulb_x + y * y <= 1.0 / 16.0;
+}
+
+static_assert(in_cardioid_or_bulb({ 0.0, 0.0 }) && in_cardioid_or_bulb({ -1.0, 0.0 }) && !in_cardioid_or_bulb({ 0.3, 0.0 }) && !in_cardioid_or_bulb({ -0.75, 0.2 }));
+
+template<typename T, typename PowerType>
+constexpr auto iterate(const std::complex<T> scaled, const std::size_t max_iteration, const PowerType power, const bool do_abs) noexcept
+{
+  auto orbit = start_orbit(scaled, max_iteration);
+  iterate(orbit, scaled, power, do_abs);
+  return orbit;
+}
+
+template<typename T> constexpr void raise_max_iteration(Orbit<T> &orbit, const std::size_t old_max_iteration, const std::size_t new_max_iteration) noexcept
+{
+  if (!orbit.escaped && orbit.stop_iteration == old_max_iteration) { orbit.stop_iteration = new_max_iteration; }
+}
+
+// Whether an orbit counts as in the set at max_iteration, which it may have been carried on
+// past: an orbit that escapes only does so if that happened before max_iteration, and it
+// always runs 5 iterations past the escape, whatever max_iteration it was started with.
+template<typename T> constexpr bool in_set(const Orbit<T> &orbit, const std::size_t max_iteration) noexcept
+{
+  return !orbit.escaped || orbit.iteration >= max_iteration + 5;
+}
+
+// The smoothed iteration count, times 10, walks through 7 bands of 256 shades and then
+// wraps around, so every color there is fits in one table that is built at compile time.
+constexpr std::size_t palette_band_size = 256;
+constexpr std::size_t palette_size      = 7 * palette_band_size;
+
+constexpr Color<double> palette_color(const std::size_t index) noexcept
+{
+  const auto colorband = index / palette_band_size;
+  const auto to_1      = static_cast<double>(index % palette_band_size) / 255.0;
+  const auto to_0      = 1.0 - to_1;
+
+  switch (colorband) {
+  case 0: return Color{ to_1, 0.0, 0.0 };
+  case 1: return Color{ 1.0, to_1, 0.0 };
+  case 2: return Color{ to_0, 1.0, 0.0 };
+  case 3: return Color{ 0.0, 1.0, to_1 };
+  case 4: return Color{ 0.0, to_0, 1.0 };
+  case 5: return Color{ to_1, 0.0, 1.0 };
+  default: return Color{ to_0, 0.0, to_0 };
+  }
+}
+
+constexpr auto palette = [] {
+  std::array<Rgba8, palette_size> colors{};
+  for (std::size_t index = 0; index < colors.size(); ++index) { colors[index] = to_rgba8(palette_color(index)); }
+  return colors;
+}();
+
+// where the smoothing overflows or has nothing to take the log of, the color the
+// out of range conversion to int used to land on
+constexpr Rgba8 palette_fallback = palette[(std::size_t{ 1 } << 31) % palette_size];
+
+// inverse_log_power is 1 / log(power), which is the same for the whole frame
+template<typename T> constexpr Rgba8 colorize(const Orbit<T> &orbit, const std::size_t max_iteration, const double inverse_log_power) noexcept
+{
+  const auto iteration = orbit.iteration;
+  const auto current   = orbit.current;
+
+  if (iteration == max_iteration || in_set(orbit, max_iteration)) {
+    return Rgba8{ 0, 0, 0 };
+  } else {
+    // both logs need something over 1 to work with
+    const auto magnitude = std::abs(static_cast<double>(std::real(current)) * static_cast<double>(std::imag(current)));
+    if (!(magnitude > 1.0 && magnitude <= std::numeric_limits<double>::max())) { return palette_fallback; }
+
+    const auto value = (static_cast<double>(iteration + 1) - fast_log(fast_log(magnitude)) * inverse_log_power) * 10.0;
+    // at power 1 there is no smoothing at all
+    if (!(std::abs(value) < 0x1p62)) { return palette_fallback; }
+    const auto colorval = static_cast<std::size_t>(std::abs(static_cast<std::int64_t>(std::floor(value))));
+    return palette[colorval % palette_size];
+  }
+}
+
+template<typename PointType, typename CenterType, typename ScaleType>
+constexpr auto scale_point(const Point<PointType> t_point, const Point<CenterType> t_center, const Size t_size, const ScaleType t_scale) noexcept
+{
+  return std::complex{ t_point.x / (t_size.width / t_scale) + (t_center.x - (t_scale / static_cast<CenterType>(2.0))),
+                       t_point.y / (t_size.height / t_scale) + (t_center.y - (t_scale / static_cast<CenterType>(2.0))) };
+}
+
+template<typename PointType, typename CenterType, typename ScaleType>
+constexpr auto get_color(const Point<PointType> t_point,
+                         const Point<CenterType> t_center,
+                         const Size t_size,
+                         const ScaleType t_scale,
+                         std::size_t max_iteration,
+                         const CenterType power,
+                         const bool do_abs) noexcept
+{
+  return colorize(iterate(scale_point(t_point, t_center, t_size, t_scale), max_iteration, power, do_abs), max_iteration, 1.0 / std::log(power));
+}
+
+#if MANDELBROT_HAS_SIMD
+// Continues simd::size() orbits at once, one per lane, with a mask of the lanes that are
+// still running. Every lane does exactly the same arithmetic in the same order as
+// iterate() + opt_pow(), including running 5 iterations past the escape, so the iteration
+// counts (and final values) match the scalar path.
+template<std::size_t Power, bool DoAbs, bool Periodicity, typename T>
+void iterate_simd(Orbit<T> *orbits, const T *scaled_real, const T *scaled_imag) noexcept
+{
+  static_assert(Power == 2 || Power == 3);
+
+  using simd           = stdx::native_simd<T>;
+  constexpr auto lanes = simd::size();
+
+  // iteration counts are kept as T so that they share the mask type with the values, the
+  // counts involved are far below where that stops being exact (2^24 for float)
+  std::array<T, lanes> lane_real{};
+  std::array<T, lanes> lane_imag{};
+  std::array<T, lanes> lane_iteration{};
+  std::array<T, lanes> lane_stop_iteration{};
+  std::array<T, lanes> lane_escaped{};
+  for (std::size_t lane = 0; lane < lanes; ++lane) {
+    lane_real[lane]           = std::real(orbits[lane].current);
+    lane_imag[lane]           = std::imag(orbits[lane].current);
+    lane_iteration[lane]      = static_cast<T>(orbits[lane].iteration);
+    lane_stop_iteration[lane] = static_cast<T>(orbits[lane].stop_iteration);
+    lane_escaped[lane]        = orbits[lane].escaped ? T{ 1 } : T{ 0 };
+  }
+
+  const simd c_real{ scaled_real, stdx::element_aligned };
+  const simd c_imag{ scaled_imag, stdx::element_aligned };
+
+  simd real{ lane_real.data(), stdx::element_aligned };
+  simd imag{ lane_imag.data(), stdx::element_aligned };
+  simd iteration{ lane_iteration.data(), stdx::element_aligned };
+  simd stop_iteration{ lane_stop_iteration.data(), stdx::element_aligned };
+  simd escaped{ lane_escaped.data(), stdx::element_aligned };
+
+  // Brent's cycle detection, like iterate()
+  simd saved_real             = real;
+  simd saved_imag             = imag;
+  std::size_t since_saved    = 0;
+  std::size_t saved_interval = 1;
+
+  for (auto running = iteration < stop_iteration; stdx::any_of(running); running = iteration < stop_iteration) {
+    const auto escaping = running && (real * real + imag * imag) > simd{ static_cast<T>(2.0 * 2.0) } && escaped == simd{ 0 };
+    stdx::where(escaping, stop_iteration) = iteration + 5;
+    stdx::where(escaping, escaped)        = 1;
+
+    // lanes that are done must keep their final value, so only ever assign through the mask
+    const simd a = DoAbs ? stdx::abs(real) : real;
+    const simd b = DoAbs ? stdx::abs(imag) : imag;
+
+    if constexpr (Power == 2) {
+      stdx::where(running, real) = (a * a - b * b) + c_real;
+      stdx::where(running, imag) = (simd{ 2 } * a * b) + c_imag;
+    } else {
+      stdx::where(running, real) = (simd{ -3 } * a * (b * b) + a * a * a) + c_real;
+      stdx::where(running, imag) = (simd{ 3 } * (a * a) * b - b * b * b) + c_imag;
+    }
+
+    stdx::where(running, iteration) += 1;
+
+    if constexpr (Periodicity) {
+      ++since_saved;
+      if (since_saved % periodicity_check_interval == 0) {
+        const auto distance = stdx::abs(real - saved_real) + stdx::abs(imag - saved_imag);
+        const auto cycling  = running && escaped == simd{ 0 } && distance < simd{ static_cast<T>(periodicity_tolerance) };
+        stdx::where(cycling, iteration) = stop_iteration;
+      }
+
+      if (since_saved == saved_interval) {
+        saved_real  = real;
+        saved_imag  = imag;
+        since_saved = 0;
+        saved_interval *= 2;
+      }
+    }
+  }
+
+  for (std::size_t lane = 0; lane < lanes; ++lane) {
+    orbits[lane] = Orbit<T>{
+      static_cast<std::size_t>(iteration[lane]), std::complex<T>{ real[lane], imag[lane] }, static_cast<std::size_t>(stop_iteration[lane]), escaped[lane] != 0
+    };
+  }
+}
+
+// continues the orbits of the given pixels, simd::size() of them at a time, in T
+template<std::size_t Power, bool DoAbs, typename T>
+void iterate_pixels_simd(Orbit<double> *orbits, const std::span<const std::size_t> pixels, const Size size, const Settings &settings)
+{
+  constexpr auto lanes = stdx::native_simd<T>::size();
+
+  std::array<T, lanes> scaled_real{};
+  std::array<T, lanes> scaled_imag{};
+  std::array<Orbit<T>, lanes> lane_orbits{};
+  const auto center = settings.approximate_center();
+
+  for (std::size_t first = 0; first < pixels.size(); first += lanes) {
+    // the last few don't fill a whole register, the lanes left over get an orbit that is
+    // already done and so never runs
+    const auto used = std::min(lanes, pixels.size() - first);
+    for (std::size_t lane = 0; lane < lanes; ++lane) {
+      if (lane < used) {
+        const auto pixel  = pixels[first + lane];
+        const auto scaled = scale_point(Point{ pixel % size.width, pixel / size.width }, center, size, settings.scale);
+        scaled_real[lane] = static_cast<T>(std::real(scaled));
+        scaled_imag[lane] = static_cast<T>(std::imag(scaled));
+        lane_orbits[lane] = orbit_cast<T>(orbits[pixel]);
+      } else {
+        scaled_real[lane] = T{};
+        scaled_imag[lane] = T{};
+        lane_orbits[lane] = Orbit<T>{};
+      }
+    }
+
+    if (settings.shortcuts.periodicity) {
+      iterate_simd<Power, DoAbs, true>(lane_orbits.data(), scaled_real.data(), scaled_imag.data());
+    } else {
+      iterate_simd<Power, DoAbs, false>(lane_orbits.data(), scaled_real.data(), scaled_imag.data());
+    }
+
+    for (std::size_t lane = 0; lane < used; ++lane) { orbits[pixels[first + lane]] = orbit_cast<double>(lane_orbits[lane]); }
+  }
+}
+#endif
+
+// Continues the orbits of the given pixels (y * width + x) in T, with SIMD for the powers
+// that have a kernel. The pixels can be from anywhere in the image, the lanes don't care.
+template<typename T = double>
+void iterate_pixels(Orbit<double> *orbits, const std::span<const std::size_t> pixels, const Size size, const Settings &settings)
+{
+#if MANDELBROT_HAS_SIMD
+  using PixelIterator            = void (*)(Orbit<double> *, std::span<const std::size_t>, Size, const Settings &);
+  const auto simd_pixel_iterator = [&]() -> PixelIterator {
+    if (settings.power == 2.0) {
+      return settings.do_abs ? &iterate_pixels_simd<2, true, T> : &iterate_pixels_simd<2, false, T>;
+    } else if (settings.power == 3.0) {
+      return settings.do_abs ? &iterate_pixels_simd<3, true, T> : &iterate_pixels_simd<3, false, T>;
+    } else {
+      return nullptr;
+    }
+  }();
+
+  if (simd_pixel_iterator != nullptr) {
+    simd_pixel_iterator(orbits, pixels, size, settings);
+    return;
+  }
+#endif
+
+  const auto center = settings.approximate_center();
+  for (const auto pixel : pixels) {
+    auto orbit        = orbit_cast<T>(orbits[pixel]);
+    const auto scaled = scale_point(Point{ pixel % size.width, pixel / size.width }, center, size, settings.scale);
+    iterate(orbit, std::complex<T>(scaled), static_cast<T>(settings.power), settings.do_abs, settings.shortcuts.periodicity);
+    orbits[pixel] = orbit_cast<double>(orbit);
+  }
+}
+
+// Double-double precision, for views that are too deep for double but not yet deep enough
+// to need perturbation. Every orbit is followed in full, as a hi part, which is what the
+// rest of the renderer sees as Orbit::current, and a lo part that is kept on the side.
+//
+// No periodicity checking: at these depths pixels outside the set shadow cycles closely
+// enough to be mistaken for them.
+
+// one iteration of z^Power + c, T is double or a SIMD vector of doubles
+template<std::size_t Power, bool DoAbs, typename T>
+constexpr std::pair<DoubleDouble<T>, DoubleDouble<T>>
+  double_double_step(const DoubleDouble<T> &real, const DoubleDouble<T> &imag, const DoubleDouble<T> &c_real, const DoubleDouble<T> &c_imag) noexcept
+{
+  static_assert(Power == 2 || Power == 3);
+
+  const auto a = DoAbs ? abs(real) : real;
+  const auto b = DoAbs ? abs(imag) : imag;
+  if constexpr (Power == 2) {
+    return { (a * a - b * b) + c_real, (a * b) * 2.0 + c_imag };
+  } else {
+    const auto aa = a * a;
+    const auto bb = b * b;
+    return { a * (aa - (bb + bb * 2.0)) + c_real, b * ((aa + aa * 2.0) - bb) + c_imag };
+  }
+}
+
+template<std::size_t Power, bool DoAbs>
+void iterate_double_double(Orbit<double> &orbit, std::complex<double> &low, const DoubleDouble<double> &c_real, const DoubleDouble<double> &c_imag) noexcept
+{
+  auto &[iteration, current, stop_iteration, escaped] = orbit;
+
+  DoubleDouble<double> real{ std::real(current), std::real(low) };
+  DoubleDouble<double> imag{ std::imag(current), std::imag(low) };
+  while (iteration < stop_iteration) {
+    if (real.hi * real.hi + imag.hi * imag.hi > (2.0 * 2.0) && !escaped) {
+      stop_iteration = iteration + 5;
+      escaped        = true;
+    }
+
+    std::tie(real, imag) = double_double_step<Power, DoAbs>(real, imag, c_real, c_imag);
+    ++iteration;
+  }
+
+  current = { real.hi, imag.hi };
+  low     = { real.lo, imag.lo };
+}
+
+#if MANDELBROT_HAS_SIMD
+// the same as iterate_double_double(), simd::size() orbits at once like iterate_simd()
+template<std::size_t Power, bool DoAbs>
+void iterate_double_double_simd(Orbit<double> *orbits, std::complex<double> *lows, const DoubleDouble<double> *c_real, const DoubleDouble<double> *c_imag) noexcept
+{
+  using simd           = stdx::native_simd<double>;
+  constexpr auto lanes = simd::size();
+
+  const auto gather = [](const auto &member) {
+    std::array<double, lanes> values{};
+    for (std::size_t lane = 0; lane < lanes; ++lane) { values[lane] = member(lane); }
+    return simd{ values.data(), stdx::element_aligned };
+  };
+
+  DoubleDouble<simd> real{ gather([&](const std::size_t lane) { return std::real(orbits[lane].current); }),
+                           gather([&](const std::size_t lane) { return std::real(lows[lane]); }) };
+  DoubleDouble<simd> imag{ gather([&](const std::size_t lane) { return std::imag(orbits[lane].current); }),
+                           gather([&](const std::size_t lane) { return std::imag(lows[lane]); }) };
+  const DoubleDouble<simd> lane_c_real{ gather([&](const std::size_t lane) { return c_real[lane].hi; }),
+                                        gather([&](const std::size_t lane) { return c_real[lane].lo; }) };
+  const DoubleDouble<simd> lane_c_imag{ gather([&](const std::size_t lane) { return c_imag[lane].hi; }),
+                                        gather([&](const std::size_t lane) { return c_imag[lane].lo; }) };
+  simd iteration      = gather([&](const std::size_t lane) { return static_cast<double>(orbits[lane].iteration); });
+  simd stop_iteration = gather([&](const std::size_t lane) { return static_cast<double>(orbits[lane].stop_iteration); });
+  simd escaped        = gather([&](const std::size_t lane) { return orbits[lane].escaped ? 1.0 : 0.0; });
+
+  for (auto running = iteration < stop_iteration; stdx::any_of(running); running = iteration < stop_iteration) {
+    const auto escaping = running && (real.hi * real.hi + imag.hi * imag.hi) > simd{ 2.0 * 2.0 } && escaped == simd{ 0 };
+    stdx::where(escaping, stop_iteration) = iteration + 5;
+    stdx::where(escaping, escaped)        = 1;
+
+    const auto [next_real, next_imag] = double_double_step<Power, DoAbs>(real, imag, lane_c_real, lane_c_imag);
+    stdx::where(running, real.hi)     = next_real.hi;
+    stdx::where(running, real.lo)     = next_real.lo;
+    stdx::where(running, imag.hi)     = next_imag.hi;
+    stdx::where(running, imag.lo)     = next_imag.lo;
+
+    stdx::where(running, iteration) += 1;
+  }
+
+  for (std::size_t lane = 0; lane < lanes; ++lane) {
+    orbits[lane] = Orbit<double>{
+      static_cast<std::size_t>(iteration[lane]), std::complex<double>{ real.hi[lane], imag.hi[lane] }, static_cast<std::size_t>(stop_iteration[lane]), escaped[lane] != 0
+    };
+    lows[lane] = std::complex<double>{ real.lo[lane], imag.lo[lane] };
+  }
+}
+#endif
+
+template<std::size_t Power, bool DoAbs>
+void iterate_pixels_double_double(Orbit<double> *orbits,
+                                  std::complex<double> *lows,
+                                  const std::span<const std::size_t> pixels,
+                                  const Size size,
+                                  const double scale,
+                                  const Point<DoubleDouble<double>> &center)
+{
+  // only the offset from the center is rounded to double, and that is tiny
+  const auto c_of = [&](const std::size_t pixel) {
+    const auto offset = scale_point(Point{ pixel % size.width, pixel / size.width }, Point{ 0.0, 0.0 }, size, scale);
+    return std::pair{ center.x + std::real(offset), center.y + std::imag(offset) };
+  };
+
+#if MANDELBROT_HAS_SIMD
+  constexpr auto lanes = stdx::native_simd<double>::size();
+
+  std::array<DoubleDouble<double>, lanes> c_real{};
+  std::array<DoubleDouble<double>, lanes> c_imag{};
+  std::array<Orbit<double>, lanes> lane_orbits{};
+  std::array<std::complex<double>, lanes> lane_lows{};
+
+  for (std::size_t first = 0; first < pixels.size(); first += lanes) {
+    const auto used = std::min(lanes, pixels.size() - first);
+    for (std::size_t lane = 0; lane < lanes; ++lane) {
+      if (lane < used) {
+        const auto pixel                  = pixels[first + lane];
+        std::tie(c_real[lane], c_imag[lane]) = c_of(pixel);
+        lane_orbits[lane]                 = orbits[pixel];
+        lane_lows[lane]                   = lows[pixel];
+      } else {
+        lane_orbits[lane] = Orbit<double>{};
+      }
+    }
+
+    iterate_double_double_simd<Power, DoAbs>(lane_orbits.data(), lane_lows.data(), c_real.data(), c_imag.data());
+
+    for (std::size_t lane = 0; lane < used; ++lane) {
+      orbits[pixels[first + lane]] = lane_orbits[lane];
+      lows[pixels[first + lane]]   = lane_lows[lane];
+    }
+  }
+#else
+  for (const auto pixel : pixels) {
+    const auto [c_real, c_imag] = c_of(pixel);
+    iterate_double_double<Power, DoAbs>(orbits[pixel], lows[pixel], c_real, c_imag);
+  }
+#endif
+}
+
+// the 8 kernels there are, chosen by power (2 or 3) and do_abs
+inline void iterate_pixels_double_double(Orbit<double> *orbits,
+                                         std::complex<double> *lows,
+                                         const std::span<const std::size_t> pixels,
+                                         const Size size,
+                                         const Settings &settings,
+                                         const Point<DoubleDouble<double>> &center)
+{
+  using PixelIterator = void (*)(Orbit<double> *, std::complex<double> *, std::span<const std::size_t>, Size, double, const Point<DoubleDouble<double>> &);
+  const auto pixel_iterator = [&]() -> PixelIterator {
+    if (settings.power == 2.0) {
+      return settings.do_abs ? &iterate_pixels_double_double<2, true> : &iterate_pixels_double_double<2, false>;
+    } else {
+      assert(settings.power == 3.0);
+      return settings.do_abs ? &iterate_pixels_double_double<3, true> : &iterate_pixels_double_double<3, false>;
+    }
+  }();
+  pixel_iterator(orbits, lows, pixels, size, settings.scale, center);
+}
+
+// A type resolves a view as long as a pixel still spans this many units in the last place
+// of the coordinates, which are up to 2 in size. The slack keeps the rounding of every
+// iteration, which chaotic orbits blow up, well below a pixel for a few thousand iterations.
+constexpr double precision_headroom = 2.0 * 1024.0;
+constexpr double double_double_epsilon = 0x1p-104;
+
+// whether precision tells the pixels of the view apart, perturbation resolves any
+[[nodiscard]] constexpr bool resolves_view(const Settings &settings, const Size size, const Precision precision) noexcept
+{
+  const auto pixel_spacing = settings.scale / std::max(size.width, size.height);
+  const auto resolves      = [&](const double epsilon) { return pixel_spacing >= epsilon * precision_headroom; };
+  switch (precision) {
+  case Precision::single:
+    return resolves(std::numeric_limits<float>::epsilon());
+  case Precision::automatic:
+  case Precision::double_precision:
+    return resolves(std::numeric_limits<double>::epsilon());
+  case Precision::double_double:
+    return resolves(double_double_epsilon);
+  case Precision::perturbation:
+    break;
+  }
+  return true;
+}
+
+// The cheapest precision that resolves the view, or the one that was asked for if it can
+// render it at all: double-double only has kernels for powers 2 and 3, single only for 2
+// (z^3 overflows a float in the 5 iterations past the escape that the coloring smooths
+// over), and perturbation is only implemented for plain z^2 + c. Past what the kernels of
+// a power reach the deepest of them is used all the same, which resolves_view() tells.
+[[nodiscard]] constexpr Precision select_precision(const Settings &settings, const Size size) noexcept
+{
+  const auto resolves         = [&](const Precision precision) { return resolves_view(settings, size, precision); };
+  const bool has_kernel       = settings.power == 2.0 || settings.power == 3.0;
+  const bool fits_float       = settings.power == 2.0;
+  const bool can_perturb      = settings.power == 2.0 && !settings.do_abs;
+
+  switch (settings.precision) {
+  case Precision::single:
+    if (fits_float) { return Precision::single; }
+    break;
+  case Precision::double_precision:
+    return Precision::double_precision;
+  case Precision::double_double:
+    if (has_kernel) { return Precision::double_double; }
+    break;
+  case Precision::perturbation:
+    if (can_perturb) { return Precision::perturbation; }
+    break;
+  case Precision::automatic:
+    break;
+  }
+
+  if (!has_kernel) { return Precision::double_precision; }
+  if (fits_float && resolves(Precision::single)) { return Precision::single; }
+  if (resolves(Precision::double_precision)) { return Precision::double_precision; }
+  if (resolves(Precision::double_double) || !can_perturb) { return Precision::double_double; }
+  return Precision::perturbation;
+}
+
+static_assert(select_precision(Settings{}, Size{ 640, 640 }) == Precision::single);
+
+// Deep zooms, where neighbouring pixels are closer together than even double-double can
+// tell apart, by perturbation: a single reference orbit at the center is iterated in full
+// precision, and every pixel only follows its small difference delta from that orbit, in
+// double. With
+// z = Z + delta and c = C + delta_c:
+//     delta' = 2 Z delta + delta^2 + delta_c
+
+// The full precision orbit of the center. values()[k] is Z_k rounded to double, counting
+// from Z_0 = 0, so the Orbit::current of a pixel at iteration n lines up with Z_(n + 1).
+class ReferenceOrbit
+{
+public:
+  void reset(const Point<Coordinate> &center_)
+  {
+    center  = center_;
+    current = {};
+    values_.assign(1, std::complex<double>{});
+    escaped = false;
+  }
+
+  // extends the orbit to length values, or up to where it escapes
+  void extend(const std::size_t length)
+  {
+    while (values_.size() < length && !escaped) {
+      const auto xx = current.x * current.x;
+      const auto yy = current.y * current.y;
+      const auto xy = current.x * current.y;
+      current       = Point{ xx - yy + center.x, xy + xy + center.y };
+      values_.emplace_back(current.x.to_double(), current.y.to_double());
+      escaped = std::norm(values_.back()) > (2.0 * 2.0);
+    }
+  }
+
+  [[nodiscard]] const std::vector<std::complex<double>> &values() const noexcept { return values_; }
+
+private:
+  Point<Coordinate> center{};
+  Point<Coordinate> current{};
+  std::vector<std::complex<double>> values_ = std::vector<std::complex<double>>(1);
+  bool escaped                              = false;
+};
+
+// Skips the start of every pixel's orbit. While delta_c is small the first iterations are
+// described well enough by delta_m = a u + b u^2 + c u^3, with u = delta_c / radius and
+// radius the largest |delta_c| in the view (which keeps a, b and c from overflowing).
+struct SeriesApproximation
+{
+  std::size_t m = 1;
+  double radius = 1.0;
+  std::complex<double> a{ 1.0 };
+  std::complex<double> b{};
+  std::complex<double> c{};
+
+  // Skips as far as the series still agrees with probes around the edge of the view, which
+  // are iterated exactly alongside it. Being off by a small fraction of a pixel is the same
+  // as sampling a slightly different point inside the pixel, and the double precision path
+  // is already off by about 1e-4 of a pixel by the time perturbation takes over.
+  [[nodiscard]] static SeriesApproximation
+    build(const std::vector<std::complex<double>> &reference, const double radius, const double pixel_spacing, const std::size_t max_iteration) noexcept
+  {
+    constexpr double tolerance = 1e-4;
+
+    std::array<std::complex<double>, 8> probe_delta_c{};
+    for (std::size_t probe = 0; probe < probe_delta_c.size(); ++probe) {
+      probe_delta_c[probe] = std::polar(radius, static_cast<double>(probe) * std::numbers::pi / 4.0);
+    }
+    auto probe_delta = probe_delta_c;
+
+    SeriesApproximation series{ 1, radius, std::complex<double>{ radius }, {}, {} };
+    while (series.m + 1 < reference.size() && series.m + 1 < max_iteration) {
+      const auto z = reference[series.m];
+      SeriesApproximation next{ series.m + 1, radius, 2.0 * z * series.a + radius, 2.0 * z * series.b + series.a * series.a, 2.0 * z * series.c + 2.0 * series.a * series.b };
+
+      // how far one pixel has been stretched to by now
+      const auto allowed_error = tolerance * std::abs(next.a) * pixel_spacing / radius;
+      const auto next_z        = std::abs(reference[next.m]);
+
+      bool valid = true;
+      for (std::size_t probe = 0; probe < probe_delta.size(); ++probe) {
+        auto &delta = probe_delta[probe];
+        delta       = 2.0 * z * delta + delta * delta + probe_delta_c[probe];
+
+        // and no pixel may escape or need rebasing in the iterations that get skipped
+        valid = valid && std::abs(next.delta(probe_delta_c[probe]) - delta) <= allowed_error && next_z + std::abs(delta) < 2.0 && std::abs(delta) * 2.0 < next_z;
+      }
+      if (!valid) { break; }
+
+      series = next;
+    }
+    return series;
+  }
+
+  [[nodiscard]] std::complex<double> delta(const std::complex<double> delta_c) const noexcept
+  {
+    const auto u = delta_c / radius;
+    return ((c * u + b) * u + a) * u;
+  }
+};
+
+// where a deep zoom pixel is relative to the reference orbit: z = reference[m] + delta
+struct DeltaOrbit
+{
+  std::size_t m{};
+  std::complex<double> delta{};
+  std::complex<double> delta_c{};
+};
+
+// Continues a deep zoom pixel, the same as iterate() but on delta. A glitch (a blob of
+// wrong, flat color) happens when z comes closer to 0 than delta is big, the reference
+// orbit no longer says anything about the pixel then. That's detected with
+// |z| < |delta| and fixed by rebasing onto the start of the reference orbit with
+// delta = z, which is exact because Z_0 = 0. Running off the end of the reference orbit
+// (because it escaped) rebases the same way.
+inline void iterate_perturbed(Orbit<double> &orbit, DeltaOrbit &delta_orbit, const std::vector<std::complex<double>> &reference) noexcept
+{
+  auto &[iteration, current, stop_iteration, escaped] = orbit;
+  auto &[m, delta, delta_c]                           = delta_orbit;
+
+  while (iteration < stop_iteration) {
+    const auto z = reference[m];
+    if (std::norm(z + delta) > (2.0 * 2.0) && !escaped) {
+      stop_iteration = iteration + 5;
+      escaped        = true;
+    }
+
+    // written out, std::complex multiplication has to care about infinities and NaNs
+    const auto zr = std::real(z);
+    const auto zi = std::imag(z);
+    const auto dr = std::real(delta);
+    const auto di = std::imag(delta);
+    delta         = std::complex{ 2.0 * (zr * dr - zi * di) + (dr * dr - di * di) + std::real(delta_c), 2.0 * (zr * di + zi * dr) + 2.0 * dr * di + std::imag(delta_c) };
+
+    ++m;
+    ++iteration;
+
+    const auto next = reference[m] + delta;
+    if (m + 1 == reference.size() || std::norm(next) < std::norm(delta)) {
+      delta = next;
+      m     = 0;
+    }
+  }
+
+  current = reference[m] + delta;
+}
+
+#if MANDELBROT_HAS_SIMD
+// the same as iterate_perturbed(), simd::size() pixels at once like iterate_simd(). Every
+// lane rebases on its own, so each reads the reference orbit at its own m.
+inline void iterate_perturbed_simd(Orbit<double> *orbits, DeltaOrbit *delta_orbits, const std::vector<std::complex<double>> &reference) noexcept
+{
+  using simd           = stdx::native_simd<double>;
+  using mask           = simd::mask_type;
+  constexpr auto lanes = simd::size();
+
+  const auto gather = [](const auto &member) {
+    std::array<double, lanes> values{};
+    for (std::size_t lane = 0; lane < lanes; ++lane) { values[lane] = member(lane); }
+    return simd{ values.data(), stdx::element_aligned };
+  };
+
+  std::array<std::size_t, lanes> m{};
+  for (std::size_t lane = 0; lane < lanes; ++lane) { m[lane] = delta_orbits[lane].m; }
+  const auto reference_real = [&] { return gather([&](const std::size_t lane) { return std::real(reference[m[lane]]); }); };
+  const auto reference_imag = [&] { return gather([&](const std::size_t lane) { return std::imag(reference[m[lane]]); }); };
+
+  simd delta_real           = gather([&](const std::size_t lane) { return std::real(delta_orbits[lane].delta); });
+  simd delta_imag           = gather([&](const std::size_t lane) { return std::imag(delta_orbits[lane].delta); });
+  const simd delta_c_real   = gather([&](const std::size_t lane) { return std::real(delta_orbits[lane].delta_c); });
+  const simd delta_c_imag   = gather([&](const std::size_t lane) { return std::imag(delta_orbits[lane].delta_c); });
+  simd iteration            = gather([&](const std::size_t lane) { return static_cast<double>(orbits[lane].iteration); });
+  simd stop_iteration       = gather([&](const std::size_t lane) { return static_cast<double>(orbits[lane].stop_iteration); });
+  simd escaped              = gather([&](const std::size_t lane) { return orbits[lane].escaped ? 1.0 : 0.0; });
+  simd z_real               = reference_real();
+  simd z_imag               = reference_imag();
+
+  for (auto running = iteration < stop_iteration; stdx::any_of(running); running = iteration < stop_iteration) {
+    const auto real     = z_real + delta_real;
+    const auto imag     = z_imag + delta_imag;
+    const auto escaping = running && (real * real + imag * imag) > simd{ 2.0 * 2.0 } && escaped == simd{ 0 };
+    stdx::where(escaping, stop_iteration) = iteration + 5;
+    stdx::where(escaping, escaped)        = 1;
+
+    const simd next_delta_real = simd{ 2.0 } * (z_real * delta_real - z_imag * delta_imag) + (delta_real * delta_real - delta_imag * delta_imag) + delta_c_real;
+    const simd next_delta_imag = simd{ 2.0 } * (z_real * delta_imag + z_imag * delta_real) + simd{ 2.0 } * delta_real * delta_imag + delta_c_imag;
+    stdx::where(running, delta_real) = next_delta_real;
+    stdx::where(running, delta_imag) = next_delta_imag;
+    stdx::where(running, iteration) += 1;
+
+    std::array<bool, lanes> at_end{};
+    for (std::size_t lane = 0; lane < lanes; ++lane) {
+      m[lane] += running[lane] ? 1 : 0;
+      at_end[lane] = m[lane] + 1 == reference.size();
+    }
+    z_real = reference_real();
+    z_imag = reference_imag();
+
+    const auto next_real = z_real + delta_real;
+    const auto next_imag = z_imag + delta_imag;
+    const auto rebasing  = running && (mask{ at_end.data(), stdx::element_aligned } || (next_real * next_real + next_imag * next_imag) < (delta_real * delta_real + delta_imag * delta_imag));
+    stdx::where(rebasing, delta_real) = next_real;
+    stdx::where(rebasing, delta_imag) = next_imag;
+    stdx::where(rebasing, z_real)     = 0.0;
+    stdx::where(rebasing, z_imag)     = 0.0;
+    for (std::size_t lane = 0; lane < lanes; ++lane) {
+      if (rebasing[lane]) { m[lane] = 0; }
+    }
+  }
+
+  for (std::size_t lane = 0; lane < lanes; ++lane) {
+    orbits[lane] = Orbit<double>{ static_cast<std::size_t>(iteration[lane]),
+                                  reference[m[lane]] + std::complex<double>{ delta_real[lane], delta_imag[lane] },
+                                  static_cast<std::size_t>(stop_iteration[lane]),
+                                  escaped[lane] != 0 };
+    delta_orbits[lane] = DeltaOrbit{ m[lane], std::complex<double>{ delta_real[lane], delta_imag[lane] }, delta_orbits[lane].delta_c };
+  }
+}
+#endif
+
+// continues the deep zoom pixels of the given pixels, simd::size() of them at a time
+inline void iterate_pixels_perturbed(Orbit<double> *orbits, DeltaOrbit *delta_orbits, const std::span<const std::size_t> pixels, const std::vector<std::complex<double>> &reference) noexcept
+{
+#if MANDELBROT_HAS_SIMD
+  constexpr auto lanes = stdx::native_simd<double>::size();
+
+  std::array<Orbit<double>, lanes> lane_orbits{};
+  std::array<DeltaOrbit, lanes> lane_deltas{};
+
+  for (std::size_t first = 0; first < pixels.size(); first += lanes) {
+    const auto used = std::min(lanes, pixels.size() - first);
+    for (std::size_t lane = 0; lane < lanes; ++lane) {
+      if (lane < used) {
+        lane_orbits[lane] = orbits[pixels[first + lane]];
+        lane_deltas[lane] = delta_orbits[pixels[first + lane]];
+      } else {
+        lane_orbits[lane] = Orbit<double>{};
+        lane_deltas[lane] = DeltaOrbit{};
+      }
+    }
+
+    iterate_perturbed_simd(lane_orbits.data(), lane_deltas.data(), reference);
+
+    for (std::size_t lane = 0; lane < used; ++lane) {
+      orbits[pixels[first + lane]]       = lane_orbits[lane];
+      delta_orbits[pixels[first + lane]] = lane_deltas[lane];
+    }
+  }
+#else
+  for (const auto pixel : pixels) { iterate_perturbed(orbits[pixel], delta_orbits[pixel], reference); }
+#endif
+}
+
+template<std::size_t Width, std::size_t Height> struct Image
+{
+  // packed, so that it goes to a texture in one update
+  std::array<Rgba8, Width * Height> colors;
+
+  const auto &operator[](const std::pair<std::size_t, std::size_t> &loc) const { return colors[loc.second * Width + loc.first]; }
+  auto &operator[](const std::pair<std::size_t, std::size_t> &loc) { return colors[loc.second * Width + loc.first]; }
+  //  auto &operator
+};
+
+// Hands the latest value from one writer thread to one reader thread, without locks and
+// without copying it. The writer fills its back buffer and publishes it by swapping it with
+// the middle one, the reader takes whatever is in the middle by swapping it with its front
+// buffer. A value the reader never got around to is simply overwritten by the next one.
+template<typename T> class TripleBuffer
+{
+public:
+  TripleBuffer()
+  {
+    for (auto &buffer : buffers) { buffer = std::make_unique<T>(); }
+  }
+
+  explicit TripleBuffer(const T &initial)
+  {
+    for (auto &buffer : buffers) { buffer = std::make_unique<T>(initial); }
+  }
+
+  // writer side
+  [[nodiscard]] T &back() noexcept { return *buffers[back_index]; }
+  void publish() noexcept { back_index = middle.exchange(back_index | fresh, std::memory_order_acq_rel) & index_mask; }
+
+  // reader side, returns true if something was published since the last call
+  bool update() noexcept
+  {
+    if ((middle.load(std::memory_order_relaxed) & fresh) == 0) { return false; }
+    front_index = middle.exchange(front_index, std::memory_order_acq_rel) & index_mask;
+    return true;
+  }
+  [[nodiscard]] const T &front() const noexcept { return *buffers[front_index]; }
+
+private:
+  static constexpr std::uint8_t index_mask = 0b011;
+  static constexpr std::uint8_t fresh      = 0b100;
+
+  std::array<std::unique_ptr<T>, 3> buffers;
+  std::uint8_t back_index = 0;
+  std::atomic<std::uint8_t> middle{ 1 };
+  std::uint8_t front_index = 2;
+};
+
+// Set by the UI whenever the view changes, and checked by the renderer between tiles so
+// that a frame nobody wants anymore is dropped as soon as possible
+class CancellationToken
+{
+public:
+  void request() noexcept { requested.store(true, std::memory_order_relaxed); }
+  void reset() noexcept { requested.store(false, std::memory_order_relaxed); }
+  [[nodiscard]] bool is_requested() const noexcept { return requested.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<bool> requested{ false };
+};
+
+// A fixed set of threads with a deque of tasks each. A worker takes its own tasks from the
+// front, in the order they were dealt, and once it runs out steals from the back of another
+// worker's deque, where the work that was meant to run last sits. The thread calling run()
+// works along as worker 0, so there are thread_count - 1 extra threads.
+class WorkStealingPool
+{
+public:
+  explicit WorkStealingPool(const std::size_t thread_count) : queues(std::max<std::size_t>(1, thread_count))
+  {
+    for (std::size_t worker = 1; worker < queues.size(); ++worker) {
+      threads.emplace_back([this, worker] { work_loop(worker); });
+    }
+  }
+
+  WorkStealingPool(const WorkStealingPool &) = delete;
+  WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+  ~WorkStealingPool()
+  {
+    {
+      std::scoped_lock lock{ mutex };
+      stopping = true;
+    }
+    work_available.notify_all();
+    for (auto &thread : threads) { thread.join(); }
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept { return queues.size(); }
+
+  // Calls task(0) .. task(count - 1) spread over the pool and returns once all of them have
+  // finished. Tasks are dealt round robin, so the lowest indices start first everywhere.
+  // Only one thread may be calling run() at a time.
+  void run(const std::size_t count, const std::function<void(std::size_t)> &task)
+  {
+    if (count == 0) { return; }
+
+    {
+      std::scoped_lock lock{ mutex };
+      current_task = &task;
+      remaining    = count;
+      for (std::size_t index = 0; index < count; ++index) {
+        auto &queue = queues[index % queues.size()];
+        std::scoped_lock queue_lock{ queue.mutex };
+        queue.tasks.push_back(index);
+      }
+      ++generation;
+    }
+    work_available.notify_all();
+
+    work(0);
+
+    std::unique_lock lock{ mutex };
+    all_done.wait(lock, [&] { return remaining == 0; });
+  }
+
+private:
+  struct Queue
+  {
+    std::mutex mutex;
+    std::deque<std::size_t> tasks;
+  };
+
+  void work_loop(const std::size_t worker)
+  {
+    std::size_t seen_generation = 0;
+    while (true) {
+      {
+        std::unique_lock lock{ mutex };
+        work_available.wait(lock, [&] { return stopping || generation != seen_generation; });
+        if (stopping) { return; }
+        seen_generation = generation;
+      }
+      work(worker);
+    }
+  }
+
+  void work(const std::size_t worker)
+  {
+    while (const auto index = next_task(worker)) {
+      (*current_task)(*index);
+
+      std::scoped_lock lock{ mutex };
+      if (--remaining == 0) { all_done.notify_all(); }
+    }
+  }
+
+  std::optional<std::size_t> next_task(const std::size_t worker)
+  {
+    {
+      auto &own = queues[worker];
+      std::scoped_lock lock{ own.mutex };
+      if (!own.tasks.empty()) {
+        const auto index = own.tasks.front();
+        own.tasks.pop_front();
+        return index;
+      }
+    }
+
+    for (std::size_t offset = 1; offset < queues.size(); ++offset) {
+      auto &victim = queues[(worker + offset) % queues.size()];
+      std::scoped_lock lock{ victim.mutex };
+      if (!victim.tasks.empty()) {
+        const auto index = victim.tasks.back();
+        victim.tasks.pop_back();
+        return index;
+      }
+    }
+
+    return std::nullopt;
+  }
+
+  std::vector<Queue> queues;
+  std::vector<std::thread> threads;
+
+  std::mutex mutex;
+  std::condition_variable work_available;
+  std::condition_variable all_done;
+  const std::function<void(std::size_t)> *current_task = nullptr;
+  std::size_t remaining                                = 0;
+  std::size_t generation                               = 0;
+  bool stopping                                        = false;
+};
+
+// Orbits from earlier views, in square tiles of a fixed grid of world pixels per zoom level:
+// world pixel (x, y) at a scale is c = (x, y) * scale / size. A view that is placed on that
+// grid can pick up whatever it has in common with any view before it at the same scale and
+// with the same formula, and only has to work out the rest. Up to a memory limit, past which
+// the least recently used tiles go first.
+//
+// The iteration budget is kept per pixel rather than being part of the key: an orbit can
+// be carried on to any larger max_iteration, and tells what it was at any smaller one (see
+// in_set), so a tile is good for any budget.
+template<std::size_t TileSize> class TileCache
+{
+public:
+  struct Key
+  {
+    double scale{};
+    std::int64_t tile_x{};
+    std::int64_t tile_y{};
+    double power{};
+    double do_abs{};
+    Precision precision{};
+    Shortcuts shortcuts{};
+
+    constexpr bool operator==(const Key &) const = default;
+  };
+
+  // pixels that were never iterated have a max_iteration of 0
+  struct Tile
+  {
+    std::array<Orbit<double>, TileSize * TileSize> orbits{};
+    std::array<std::size_t, TileSize * TileSize> max_iterations{};
+  };
+
+  explicit TileCache(const std::size_t max_bytes) : max_tiles{ std::max<std::size_t>(1, max_bytes / sizeof(Entry)) } {}
+
+  // nullptr if it's not cached
+  [[nodiscard]] const Tile *find(const Key &key)
+  {
+    const auto found = index.find(key);
+    if (found == index.end()) { return nullptr; }
+    tiles.splice(tiles.begin(), tiles, found->second);
+    return &found->second->tile;
+  }
+
+  // the cached tile, or an empty one in place of the least recently used
+  [[nodiscard]] Tile &insert(const Key &key)
+  {
+    if (const auto found = index.find(key); found != index.end()) {
+      tiles.splice(tiles.begin(), tiles, found->second);
+      return found->second->tile;
+    }
+
+    if (tiles.size() >= max_tiles) {
+      // reuses the memory of the evicted tile
+      index.erase(tiles.back().key);
+      tiles.splice(tiles.begin(), tiles, std::prev(tiles.end()));
+      tiles.front().key = key;
+      tiles.front().tile.max_iterations.fill(0);
+    } else {
+      tiles.emplace_front(Entry{ key, {} });
+    }
+    index.emplace(key, tiles.begin());
+    return tiles.front().tile;
+  }
+
+  void clear() noexcept
+  {
+    index.clear();
+    tiles.clear();
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept { return tiles.size(); }
+
+private:
+  struct Entry
+  {
+    Key key;
+    Tile tile;
+  };
+
+  struct KeyHash
+  {
+    std::size_t operator()(const Key &key) const noexcept
+    {
+      std::size_t hash = 0;
+      const auto combine = [&](const auto &value) { hash ^= std::hash<std::decay_t<decltype(value)>>{}(value) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2); };
+      combine(key.scale);
+      combine(key.tile_x);
+      combine(key.tile_y);
+      combine(key.power);
+      combine(key.do_abs);
+      combine(key.precision);
+      combine(key.shortcuts.interior_checks);
+      combine(key.shortcuts.periodicity);
+      combine(key.shortcuts.mariani_silver);
+      return hash;
+    }
+  };
+
+  // most recently used first
+  std::list<Entry> tiles;
+  std::unordered_map<Key, typename std::list<Entry>::iterator, KeyHash> index;
+  std::size_t max_tiles;
+};
+
+// Keeps the orbit of every pixel between frames, so that raising the max iterations for the
+// same view only continues the pixels that haven't escaped yet instead of starting over.
+// A new view is rendered coarse to fine, every 4th pixel each way, then every 2nd, then all
+// of them, and a preview is published after each pass. Views in single and double precision
+// are moved by less than half a pixel onto the grid of the TileCache, which the pixels of
+// the view being left go into and the next view is started from, so panning only works out
+// the newly exposed pixels and going back to where it has been is close to free.
+//
+// Each pass is split into tiles that go to a work stealing pool. Pixel costs differ by
+// orders of magnitude between the inside and the outside of the set, so the tiles that
+// were the most expensive in the last full resolution pass go first, and are split in four
+// if they'd otherwise hold everyone else up at the end. Ties go to the tiles nearest the
+// center of the screen.
+template<std::size_t Width, std::size_t Height> class ProgressiveRenderer
+{
+public:
+  static constexpr std::size_t tile_size  = 32;
+  static constexpr std::size_t tiles_x    = (Width + tile_size - 1) / tile_size;
+  static constexpr std::size_t tiles_y    = (Height + tile_size - 1) / tile_size;
+  static constexpr std::size_t tile_count = tiles_x * tiles_y;
+  // about a dozen screens' worth
+  static constexpr std::size_t tile_cache_bytes = std::size_t{ 256 } * 1024 * 1024;
+
+  struct TileStats
+  {
+    std::uint64_t iterations{};
+    std::chrono::nanoseconds time{};
+  };
+
+  explicit ProgressiveRenderer(const bool previews_ = true, const std::size_t threads = std::max(1u, std::thread::hardware_concurrency()))
+    : previews{ previews_ }, pool{ threads }
+  {
+    // spiral out from the center: by ring, then by angle
+    std::iota(begin(spiral), end(spiral), std::size_t{ 0 });
+    const auto ring_and_angle = [](const std::size_t tile) {
+      const auto dx = static_cast<double>(tile % tiles_x) + 0.5 - static_cast<double>(tiles_x) / 2.0;
+      const auto dy = static_cast<double>(tile / tiles_x) + 0.5 - static_cast<double>(tiles_y) / 2.0;
+      return std::pair{ std::max(std::abs(dx), std::abs(dy)), std::atan2(dy, dx) };
+    };
+    std::sort(begin(spiral), end(spiral), [&](const auto lhs, const auto rhs) { return ring_and_angle(lhs) < ring_and_angle(rhs); });
+  }
+
+  // what the current view is rendered in
+  [[nodiscard]] Precision precision() const noexcept { return view_precision; }
+
+  // iterations done and time spent per tile (row major) in the last full resolution pass,
+  // the time of a tile that was split up is the sum of its parts
+  [[nodiscard]] const std::array<TileStats, tile_count> &tile_stats() const noexcept { return last_tile_stats; }
+
+  // forgets every orbit, cached ones too, the next render starts from scratch
+  void reset() noexcept
+  {
+    forget_orbits();
+    cache.clear();
+  }
+
+  // Colors every pass into frames.back() and publishes it, returns false if it was
+  // cancelled before the full resolution image was done. A max_iteration below the last
+  // one is fine too, orbits that have been carried on further are colored as they were
+  // at max_iteration.
+  template<typename Frames> bool render(Frames &frames, const Settings &settings, const std::size_t max_iteration, const CancellationToken &cancel)
+  {
+    if (!view || !same_view(settings, *view)) { start_view(settings, max_iteration); }
+
+    if (view_precision == Precision::perturbation) { reference.extend(max_iteration + 1); }
+
+    for (const std::size_t step : { 4u, 2u, 1u }) {
+      // once there is a full resolution image on screen previews would only be a step backwards
+      if (step != 1 && (have_full_resolution || !previews)) { continue; }
+
+      if (!iterate_pass(step, rendered_view, max_iteration, cancel)) { return false; }
+      // every pixel gets colored, so it doesn't matter which frame the back buffer last held
+      colorize_pass(frames.back(), step, rendered_view, max_iteration);
+      frames.publish();
+    }
+
+    have_full_resolution = true;
+    return true;
+  }
+
+private:
+  static constexpr Size size{ Width, Height };
+
+  // the world pixel that the top left pixel of the view is on
+  struct GridPlacement
+  {
+    std::int64_t x{};
+    std::int64_t y{};
+  };
+
+  void forget_orbits() noexcept
+  {
+    std::fill(begin(max_iterations), end(max_iterations), std::size_t{ 0 });
+    have_full_resolution = false;
+  }
+
+  void start_view(const Settings &settings, const std::size_t max_iteration)
+  {
+    store_tiles();
+    forget_orbits();
+    view          = settings;
+    rendered_view = settings;
+
+    view_precision = select_precision(settings, size);
+    if (view_precision == Precision::perturbation) {
+      reference.reset(settings.center);
+      reference.extend(max_iteration + 1);
+      const auto pixel_spacing = settings.scale / std::max(Width, Height);
+      series                   = SeriesApproximation::build(reference.values(), settings.scale * std::numbers::sqrt2 / 2.0, pixel_spacing, max_iteration);
+      deltas.resize(Width * Height);
+    } else if (view_precision == Precision::double_double) {
+      double_double_center = settings.double_double_center();
+      lows.resize(Width * Height);
+    }
+
+    placement = place_on_grid(rendered_view, view_precision);
+    load_tiles();
+  }
+
+  // Moves the center of the view so that its pixels land on world pixels. Only in single
+  // and double precision, where c is worked out in double from the center anyway, and an
+  // orbit depends on nothing but its own c; deeper views aren't cached.
+  [[nodiscard]] static std::optional<GridPlacement> place_on_grid(Settings &settings, const Precision precision)
+  {
+    if (precision != Precision::single && precision != Precision::double_precision) { return std::nullopt; }
+
+    const auto spacing_x = settings.scale / Width;
+    const auto spacing_y = settings.scale / Height;
+    const auto center    = settings.approximate_center();
+    const auto world_x   = std::round((center.x - settings.scale / 2.0) / spacing_x);
+    const auto world_y   = std::round((center.y - settings.scale / 2.0) / spacing_y);
+    // so far out that world pixels can't be told apart in a double any more
+    if (!(std::abs(world_x) < 0x1p52 && std::abs(world_y) < 0x1p52)) { return std::nullopt; }
+
+    settings.center = { Coordinate{ world_x * spacing_x + settings.scale / 2.0 }, Coordinate{ world_y * spacing_y + settings.scale / 2.0 } };
+    return GridPlacement{ static_cast<std::int64_t>(world_x), static_cast<std::int64_t>(world_y) };
+  }
+
+  [[nodiscard]] typename TileCache<tile_size>::Key cache_key(const std::int64_t tile_x, const std::int64_t tile_y) const noexcept
+  {
+    return { rendered_view.scale, tile_x, tile_y, rendered_view.power, rendered_view.do_abs, view_precision, rendered_view.shortcuts };
+  }
+
+  // Calls visit(key, x0, y0, x1, y1, offset) for every cached tile the view overlaps, with
+  // the part of the screen it covers, and offset the index in the tile of screen pixel
+  // (0, 0), as if the tile went on that far.
+  template<typename Visit> void for_each_cached_tile(const Visit &visit) const
+  {
+    const auto tile       = static_cast<std::int64_t>(tile_size);
+    const auto world_tile = [&](const std::int64_t world) { return world >= 0 ? world / tile : (world - tile + 1) / tile; };
+
+    for (auto tile_y = world_tile(placement->y); tile_y <= world_tile(placement->y + std::int64_t{ Height } - 1); ++tile_y) {
+      for (auto tile_x = world_tile(placement->x); tile_x <= world_tile(placement->x + std::int64_t{ Width } - 1); ++tile_x) {
+        // the tile's top left corner on screen
+        const auto left = tile_x * tile - placement->x;
+        const auto top  = tile_y * tile - placement->y;
+        const auto x0   = static_cast<std::size_t>(std::max<std::int64_t>(left, 0));
+        const auto y0   = static_cast<std::size_t>(std::max<std::int64_t>(top, 0));
+        const auto x1   = static_cast<std::size_t>(std::min<std::int64_t>(left + tile, std::int64_t{ Width }));
+        const auto y1   = static_cast<std::size_t>(std::min<std::int64_t>(top + tile, std::int64_t{ Height }));
+        visit(cache_key(tile_x, tile_y), x0, y0, x1, y1, -top * tile - left);
+      }
+    }
+  }
+
+  // keeps every pixel that's further along than what the cache has for it
+  void store_tiles()
+  {
+    if (!placement) { return; }
+
+    for_each_cached_tile([&](const auto &key, const std::size_t x0, const std::size_t y0, const std::size_t x1, const std::size_t y1, const std::int64_t offset) {
+      const auto started = [&] {
+        for (auto y = y0; y < y1; ++y) {
+          for (auto x = x0; x < x1; ++x) {
+            if (max_iterations[y * Width + x] != 0) { return true; }
+          }
+        }
+        return false;
+      };
+      if (!started()) { return; }
+
+      auto &tile = cache.insert(key);
+      for (auto y = y0; y < y1; ++y) {
+        for (auto x = x0; x < x1; ++x) {
+          const auto pixel  = y * Width + x;
+          const auto cached = static_cast<std::size_t>(offset + static_cast<std::int64_t>(y * tile_size + x));
+          if (max_iterations[pixel] > tile.max_iterations[cached]) {
+            tile.orbits[cached]         = orbits[pixel];
+            tile.max_iterations[cached] = max_iterations[pixel];
+          }
+        }
+      }
+    });
+  }
+
+  void load_tiles()
+  {
+    if (!placement) { return; }
+
+    for_each_cached_tile([&](const auto &key, const std::size_t x0, const std::size_t y0, const std::size_t x1, const std::size_t y1, const std::int64_t offset) {
+      const auto *tile = cache.find(key);
+      if (tile == nullptr) { return; }
+
+      for (auto y = y0; y < y1; ++y) {
+        for (auto x = x0; x < x1; ++x) {
+          const auto pixel  = y * Width + x;
+          const auto cached = static_cast<std::size_t>(offset + static_cast<std::int64_t>(y * tile_size + x));
+          orbits[pixel]         = tile->orbits[cached];
+          max_iterations[pixel] = tile->max_iterations[cached];
+        }
+      }
+    });
+  }
+
+  static bool same_view(const Settings &lhs, const Settings &rhs) noexcept
+  {
+    return lhs.center == rhs.center && lhs.scale == rhs.scale && lhs.power == rhs.power && lhs.do_abs == rhs.do_abs && lhs.shortcuts == rhs.shortcuts
+           && lhs.precision == rhs.precision;
+  }
+
+  struct TileTask
+  {
+    std::size_t tile;
+    std::size_t x0;
+    std::size_t y0;
+    std::size_t x1;
+    std::size_t y1;
+    std::uint64_t cost;
+  };
+
+  [[nodiscard]] std::vector<TileTask> plan_tiles() const
+  {
+    std::uint64_t total_cost = 0;
+    for (const auto &stats : last_tile_stats) { total_cost += stats.iterations; }
+    // a tile that is more than a few times the average share of one thread would be a
+    // straggler no matter how early it starts
+    const auto split_cost = 2 * total_cost / std::max<std::size_t>(1, tile_count / pool.size());
+
+    std::vector<TileTask> tasks;
+    for (const auto tile : spiral) {
+      const auto x0   = tile % tiles_x * tile_size;
+      const auto y0   = tile / tiles_x * tile_size;
+      const auto x1   = std::min(Width, x0 + tile_size);
+      const auto y1   = std::min(Height, y0 + tile_size);
+      const auto cost = last_tile_stats[tile].iterations;
+
+      if (pool.size() > 1 && cost > split_cost && split_cost > 0) {
+        const auto xm = std::min(x1, x0 + tile_size / 2);
+        const auto ym = std::min(y1, y0 + tile_size / 2);
+        tasks.push_back(TileTask{ tile, x0, y0, xm, ym, cost / 4 });
+        tasks.push_back(TileTask{ tile, xm, y0, x1, ym, cost / 4 });
+        tasks.push_back(TileTask{ tile, x0, ym, xm, y1, cost / 4 });
+        tasks.push_back(TileTask{ tile, xm, ym, x1, y1, cost / 4 });
+      } else {
+        tasks.push_back(TileTask{ tile, x0, y0, x1, y1, cost });
+      }
+    }
+
+    // stable, so the spiral decides between tiles of the same cost (all of them, at first)
+    std::stable_sort(begin(tasks), end(tasks), [](const auto &lhs, const auto &rhs) { return lhs.cost > rhs.cost; });
+    return tasks;
+  }
+
+  bool iterate_pass(const std::size_t step, const Settings &settings, const std::size_t max_iteration, const CancellationToken &cancel)
+  {
+    const auto tasks = plan_tiles();
+
+    std::array<std::atomic<std::uint64_t>, tile_count> iterations{};
+    std::array<std::atomic<std::int64_t>, tile_count> nanoseconds{};
+    std::atomic<bool> skipped_tile{ false };
+
+    pool.run(tasks.size(), [&](const std::size_t index) {
+      if (cancel.is_requested()) {
+        skipped_tile = true;
+        return;
+      }
+
+      const auto &task = tasks[index];
+      const auto start = std::chrono::steady_clock::now();
+      const auto done  = step == 1 && use_mariani_silver(settings) ? mariani_silver(task.x0, task.y0, task.x1, task.y1, settings, max_iteration)
+                                                                   : iterate_rectangle(task.x0, task.y0, task.x1, task.y1, step, settings, max_iteration);
+
+      iterations[task.tile] += done;
+      nanoseconds[task.tile] += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    });
+
+    if (skipped_tile) { return false; }
+
+    if (step == 1) {
+      for (std::size_t tile = 0; tile < tile_count; ++tile) {
+        last_tile_stats[tile] = TileStats{ iterations[tile], std::chrono::nanoseconds{ nanoseconds[tile] } };
+      }
+    }
+    return true;
+  }
+
+  // iterates every step-th pixel of every step-th row of the rectangle (at most a tile)
+  std::uint64_t iterate_rectangle(const std::size_t x0,
+                                  const std::size_t y0,
+                                  const std::size_t x1,
+                                  const std::size_t y1,
+                                  const std::size_t step,
+                                  const Settings &settings,
+                                  const std::size_t max_iteration)
+  {
+    std::array<std::size_t, tile_size * tile_size> pixels{};
+    std::size_t count = 0;
+    for (auto y = y0; y < y1; ++y) {
+      if (y % step != 0) { continue; }
+      for (auto x = x0; x < x1; x += step) { pixels[count++] = y * Width + x; }
+    }
+    return iterate_pixel_pass({ pixels.data(), count }, settings, max_iteration);
+  }
+
+  // the set has to be connected and without holes, which z^2 + c and z^3 + c are
+  static bool use_mariani_silver(const Settings &settings) noexcept
+  {
+    return settings.shortcuts.mariani_silver && !settings.do_abs && (settings.power == 2.0 || settings.power == 3.0);
+  }
+
+  // Mariani-Silver: the set is connected and has no holes, so if the border of a rectangle
+  // is entirely in the set so is everything inside it. Works out the border and either
+  // fills the inside or splits the rectangle in four and tries again on the quarters. Only
+  // as exact as the pixel grid: a filament thinner than a pixel can slip through a border.
+  std::uint64_t mariani_silver(const std::size_t x0, const std::size_t y0, const std::size_t x1, const std::size_t y1, const Settings &settings, const std::size_t max_iteration)
+  {
+    // below this there's hardly any inside left to save
+    constexpr std::size_t min_size = 8;
+    if (x1 - x0 < min_size || y1 - y0 < min_size) { return iterate_rectangle(x0, y0, x1, y1, 1, settings, max_iteration); }
+
+    // All of the border in one go, so that the columns fill SIMD lanes as well as the rows.
+    // Goes around it one side after the other: neighbours take about as long as each other,
+    // and make for lanes that finish together.
+    std::array<std::size_t, 4 * tile_size> border{};
+    std::size_t count = 0;
+    for (auto x = x0; x < x1; ++x) { border[count++] = y0 * Width + x; }
+    for (auto y = y0 + 1; y < y1; ++y) { border[count++] = y * Width + x1 - 1; }
+    for (auto x = x1 - 1; x-- > x0;) { border[count++] = (y1 - 1) * Width + x; }
+    for (auto y = y1 - 1; --y > y0;) { border[count++] = y * Width + x0; }
+    const auto done = iterate_pixel_pass({ border.data(), count }, settings, max_iteration);
+
+    const auto pixel_in_set = [&](const std::size_t x, const std::size_t y) { return in_set(orbits[y * Width + x], max_iteration); };
+
+    std::size_t border_in_set = 0;
+    for (auto x = x0; x < x1; ++x) { border_in_set += (pixel_in_set(x, y0) ? 1 : 0) + (pixel_in_set(x, y1 - 1) ? 1 : 0); }
+    for (auto y = y0 + 1; y < y1 - 1; ++y) { border_in_set += (pixel_in_set(x0, y) ? 1 : 0) + (pixel_in_set(x1 - 1, y) ? 1 : 0); }
+
+    // Nothing on the border in the set: there could still be a small island inside, but
+    // splitting up is unlikely to find an all-in-set border again, and is only overhead.
+    if (border_in_set == 0) { return done + iterate_rectangle(x0 + 1, y0 + 1, x1 - 1, y1 - 1, 1, settings, max_iteration); }
+
+    if (border_in_set == count) {
+      for (auto y = y0 + 1; y < y1 - 1; ++y) {
+        for (auto x = x0 + 1; x < x1 - 1; ++x) {
+          const auto pixel = y * Width + x;
+          if (max_iterations[pixel] >= max_iteration) { continue; }
+          // colors as in the set, but isn't a real orbit that could be continued, so
+          // max_iterations says it has to start over when the budget goes up
+          orbits[pixel]         = Orbit<double>{ max_iteration, {}, max_iteration, false };
+          max_iterations[pixel] = 0;
+        }
+      }
+      return done;
+    }
+
+    const auto xm = (x0 + x1) / 2;
+    const auto ym = (y0 + y1) / 2;
+    return done + mariani_silver(x0, y0, xm, ym, settings, max_iteration) + mariani_silver(xm, y0, x1, ym, settings, max_iteration)
+           + mariani_silver(x0, ym, xm, y1, settings, max_iteration) + mariani_silver(xm, ym, x1, y1, settings, max_iteration);
+  }
+
+  // Iterates the given pixels (y * Width + x), returns the number of iterations done. Brings
+  // every pixel up to date with max_iteration first, leaving the ones that are already past
+  // it alone, and reuses pixels to collect the ones that actually have iterations left to do.
+  std::uint64_t iterate_pixel_pass(std::span<std::size_t> pixels, const Settings &settings, const std::size_t max_iteration)
+  {
+    const auto center = settings.approximate_center();
+    // a double c is too coarse to tell which side of the boundary a deeper pixel is on
+    const auto interior_checks = (view_precision == Precision::single || view_precision == Precision::double_precision) && settings.shortcuts.interior_checks
+                                 && settings.power == 2.0 && !settings.do_abs;
+
+    std::size_t count = 0;
+    for (const auto pixel : pixels) {
+      if (max_iterations[pixel] >= max_iteration) { continue; }
+
+      const Point point{ pixel % Width, pixel / Width };
+      auto &orbit = orbits[pixel];
+
+      if (interior_checks && in_cardioid_or_bulb(scale_point(point, center, size, settings.scale))) {
+        orbit                 = Orbit<double>{ max_iteration, {}, max_iteration, false };
+        max_iterations[pixel] = max_iteration;
+        continue;
+      }
+
+      if (max_iterations[pixel] == 0 && view_precision == Precision::perturbation) {
+        // the series approximation takes care of the first iterations
+        const auto delta_c = scale_point(point, Point{ 0.0, 0.0 }, size, settings.scale);
+        const auto delta   = series.delta(delta_c);
+        deltas[pixel]      = DeltaOrbit{ series.m, delta, delta_c };
+        orbit              = Orbit<double>{ series.m - 1, reference.values()[series.m] + delta, max_iteration, false };
+      } else if (max_iterations[pixel] == 0 && view_precision == Precision::double_double) {
+        const auto offset = scale_point(point, Point{ 0.0, 0.0 }, size, settings.scale);
+        const auto c_real = double_double_center.x + std::real(offset);
+        const auto c_imag = double_double_center.y + std::imag(offset);
+        orbit             = start_orbit(std::complex{ c_real.hi, c_imag.hi }, max_iteration);
+        lows[pixel]       = std::complex{ c_real.lo, c_imag.lo };
+      } else if (max_iterations[pixel] == 0) {
+        orbit = start_orbit(scale_point(point, center, size, settings.scale), max_iteration);
+      } else {
+        raise_max_iteration(orbit, max_iterations[pixel], max_iteration);
+      }
+      max_iterations[pixel] = max_iteration;
+
+      if (orbit.iteration < orbit.stop_iteration) { pixels[count++] = pixel; }
+    }
+
+    const std::span<const std::size_t> to_iterate{ pixels.data(), count };
+    const auto iterations_done = [&] {
+      std::uint64_t total = 0;
+      for (const auto pixel : to_iterate) { total += orbits[pixel].iteration; }
+      return total;
+    };
+
+    const auto before = iterations_done();
+    switch (view_precision) {
+    case Precision::automatic:
+    case Precision::double_precision:
+      iterate_pixels<double>(orbits.data(), to_iterate, size, settings);
+      break;
+    case Precision::single:
+      iterate_pixels<float>(orbits.data(), to_iterate, size, settings);
+      break;
+    case Precision::double_double:
+      iterate_pixels_double_double(orbits.data(), lows.data(), to_iterate, size, settings, double_double_center);
+      break;
+    case Precision::perturbation:
+      iterate_pixels_perturbed(orbits.data(), deltas.data(), to_iterate, reference.values());
+      break;
+    }
+    return iterations_done() - before;
+  }
+
+  // every pixel takes the color of the nearest pixel that was computed in this pass
+  void colorize_pass(Image<Width, Height> &img, const std::size_t step, const Settings &settings, const std::size_t max_iteration)
+  {
+    const auto inverse_log_power = 1.0 / std::log(settings.power);
+    pool.run(Height, [&](const std::size_t y) {
+      const auto *source_row = &orbits[(y - y % step) * Width];
+      for (std::size_t x = 0; x < Width; ++x) { img[{ x, y }] = colorize(source_row[x - x % step], max_iteration, inverse_log_power); }
+    });
+  }
+
+  std::vector<Orbit<double>> orbits = std::vector<Orbit<double>>(Width * Height);
+  // the max_iteration each pixel has been brought up to, 0 if it hasn't been started
+  std::vector<std::size_t> max_iterations = std::vector<std::size_t>(Width * Height);
+  // as asked for, and as rendered, which is on the grid of the cache if it can be
+  std::optional<Settings> view;
+  Settings rendered_view{};
+  std::optional<GridPlacement> placement;
+  TileCache<tile_size> cache{ tile_cache_bytes };
+
+  // never automatic, that has been resolved by select_precision()
+  Precision view_precision = Precision::double_precision;
+
+  // only used at double-double precision, the lo parts of the orbits
+  Point<DoubleDouble<double>> double_double_center{};
+  std::vector<std::complex<double>> lows;
+
+  // only used for perturbation
+  ReferenceOrbit reference;
+  SeriesApproximation series;
+  std::vector<DeltaOrbit> deltas;
+
+  bool have_full_resolution      = false;
+  bool previews                  = true;
+
+  std::array<std::size_t, tile_count> spiral{};
+  std::array<TileStats, tile_count> last_tile_stats{};
+  WorkStealingPool pool;
+};
+
+// lets ProgressiveRenderer draw straight into an Image that nobody else is looking at
+template<std::size_t Width, std::size_t Height> struct SingleFrame
+{
+  Image<Width, Height> &img;
+
+  Image<Width, Height> &back() noexcept { return img; }
+  void publish() noexcept {}
+};
+
+// renders a whole frame in one go, for when there is nobody to show previews to
+template<std::size_t Width, std::size_t Height> void render(Image<Width, Height> &img, const Settings &settings, const std::size_t max_iteration)
+{
+  SingleFrame<Width, Height> frame{ img };
+  const CancellationToken never_cancelled;
+  const auto renderer = std::make_unique<ProgressiveRenderer<Width, Height>>(false);
+  renderer->render(frame, settings, max_iteration, never_cancelled);
+}
+
+// Renders on its own thread until it's told to stop. Settings come in from the UI through
+// the settings mailbox, finished frames go out through frames.
+template<std::size_t Width, std::size_t Height>
+void run(TripleBuffer<Image<Width, Height>> *frames, TripleBuffer<Settings> *settings_mailbox, CancellationToken *cancel)
+{
+  auto renderer = std::make_unique<ProgressiveRenderer<Width, Height>>();
+
+  cancel->reset();
+  settings_mailbox->update();
+  auto settings = settings_mailbox->front();
+
+  auto cur_max_iterations = settings.cur_max_iterations;
+
+  while (!settings.canceling) {
+    const auto start = std::chrono::system_clock::now();
+    bool finished    = true;
+
+    if (cur_max_iterations <= max_max_iterations) {
+      finished = renderer->render(*frames, settings, cur_max_iterations, *cancel);
+
+      if (finished && cur_max_iterations + max_iteration_increment >= max_max_iterations) {
+        std::cout << "Max iterations rendered in " << std::chrono::duration<double>{ std::chrono::system_clock::now() - start }.count() << "s\n";
+      }
+    }
+
+    // reset before reading the settings, any change made after this cancels the next frame
+    cancel->reset();
+
+    if (settings_mailbox->update() && settings_mailbox->front() != settings) {
+      settings           = settings_mailbox->front();
+      cur_max_iterations = settings.cur_max_iterations;
+    } else if (finished) {
+      cur_max_iterations += max_iteration_increment;
+    }
+
+    std::this_thread::yield();
+  }
+}
+
+#endif
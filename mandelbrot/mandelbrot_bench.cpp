@@ -0,0 +1,128 @@
+#include "mandelbrot.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string_view>
+
+constexpr static Size size{ 640u, 640u };
+
+// Full frames from scratch, no previews, on range(0) threads. Reports pixels per second so
+// that views with different costs can be compared, and the time of the slowest tile as a
+// fraction of one thread's fair share of the frame: close to 1.0 that one tile alone keeps
+// the frame from scaling any further.
+static void Mandelbrot_Render(benchmark::State &state,
+                              const std::string_view center_x,
+                              const std::string_view center_y,
+                              const double scale,
+                              const std::size_t max_iteration,
+                              const Shortcuts shortcuts,
+                              const Precision precision)
+{
+  const auto threads = static_cast<std::size_t>(state.range(0));
+
+  Settings settings{};
+  settings.center    = { Coordinate::from_string(center_x), Coordinate::from_string(center_y) };
+  settings.scale     = scale;
+  settings.shortcuts = shortcuts;
+  settings.precision = precision;
+
+  const auto img      = std::make_unique<Image<size.width, size.height>>();
+  const auto renderer = std::make_unique<ProgressiveRenderer<size.width, size.height>>(false, threads);
+  SingleFrame<size.width, size.height> frame{ *img };
+  const CancellationToken never_cancelled;
+
+  for (auto _ : state) {
+    renderer->reset();
+    renderer->render(frame, settings, max_iteration, never_cancelled);
+    benchmark::DoNotOptimize(img->colors.data());
+    benchmark::ClobberMemory();
+  }
+
+  state.counters["pixels"] = benchmark::Counter(static_cast<double>(state.iterations()) * size.width * size.height, benchmark::Counter::kIsRate);
+
+  std::chrono::nanoseconds total{};
+  std::chrono::nanoseconds slowest{};
+  for (const auto &stats : renderer->tile_stats()) {
+    total += stats.time;
+    slowest = std::max(slowest, stats.time);
+  }
+  state.counters["slowest_tile_share"] = static_cast<double>(slowest.count()) * static_cast<double>(threads) / static_cast<double>(std::max<std::int64_t>(1, total.count()));
+}
+
+// A full frame first, then every iteration moves the view 10 pixels, like holding down
+// Shift and an arrow key: only the newly exposed pixels have to be worked out, the rest
+// comes from the renderer's tile cache.
+static void Mandelbrot_Pan(benchmark::State &state, const std::string_view center_x, const std::string_view center_y, const double scale, const std::size_t max_iteration)
+{
+  const auto threads = static_cast<std::size_t>(state.range(0));
+
+  Settings settings{};
+  settings.center = { Coordinate::from_string(center_x), Coordinate::from_string(center_y) };
+  settings.scale  = scale;
+
+  const auto img      = std::make_unique<Image<size.width, size.height>>();
+  const auto renderer = std::make_unique<ProgressiveRenderer<size.width, size.height>>(false, threads);
+  SingleFrame<size.width, size.height> frame{ *img };
+  const CancellationToken never_cancelled;
+
+  renderer->render(frame, settings, max_iteration, never_cancelled);
+  for (auto _ : state) {
+    settings.center.x += Coordinate{ 10 * settings.scale / size.width };
+    renderer->render(frame, settings, max_iteration, never_cancelled);
+    benchmark::DoNotOptimize(img->colors.data());
+    benchmark::ClobberMemory();
+  }
+
+  state.counters["pixels"] = benchmark::Counter(static_cast<double>(state.iterations()) * size.width * size.height, benchmark::Counter::kIsRate);
+}
+
+#define ADD_RENDER_BENCHMARK_WITH(name, center_x, center_y, scale, max_iteration, shortcuts, precision)      \
+  BENCHMARK_CAPTURE(Mandelbrot_Render, name, center_x, center_y, scale, max_iteration, shortcuts, precision) \
+    ->DenseRange(1, static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))                   \
+    ->UseRealTime()                                                                                        \
+    ->Unit(benchmark::kMillisecond)
+
+#define ADD_RENDER_BENCHMARK(name, center_x, center_y, scale, max_iteration) \
+  ADD_RENDER_BENCHMARK_WITH(name, center_x, center_y, scale, max_iteration, Shortcuts{}, Precision::automatic)
+
+#define ADD_PAN_BENCHMARK(name, center_x, center_y, scale, max_iteration)                \
+  BENCHMARK_CAPTURE(Mandelbrot_Pan, name, center_x, center_y, scale, max_iteration)         \
+    ->DenseRange(1, static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))) \
+    ->UseRealTime()                                                                      \
+    ->Unit(benchmark::kMillisecond)
+
+// each shortcut on its own and none at all, to see what they buy over plain iteration
+#define ADD_SHORTCUT_BENCHMARKS(name, center_x, center_y, scale, max_iteration)                                                                             \
+  ADD_RENDER_BENCHMARK_WITH(name##_No_Shortcuts, center_x, center_y, scale, max_iteration, (Shortcuts{ false, false, false }), Precision::automatic);      \
+  ADD_RENDER_BENCHMARK_WITH(name##_Interior_Checks_Only, center_x, center_y, scale, max_iteration, (Shortcuts{ true, false, false }), Precision::automatic); \
+  ADD_RENDER_BENCHMARK_WITH(name##_Periodicity_Only, center_x, center_y, scale, max_iteration, (Shortcuts{ false, true, false }), Precision::automatic);     \
+  ADD_RENDER_BENCHMARK_WITH(name##_Mariani_Silver_Only, center_x, center_y, scale, max_iteration, (Shortcuts{ false, false, true }), Precision::automatic)
+
+// the same view in a tier other than the one it would pick by itself
+#define ADD_PRECISION_BENCHMARK(name, center_x, center_y, scale, max_iteration, precision) \
+  ADD_RENDER_BENCHMARK_WITH(name, center_x, center_y, scale, max_iteration, Shortcuts{}, precision)
+
+// the whole set, mostly cheap escapes
+ADD_RENDER_BENCHMARK(Full_Set, "-0.5", "0.0", 3.0, max_max_iterations);
+ADD_SHORTCUT_BENCHMARKS(Full_Set, "-0.5", "0.0", 3.0, max_max_iterations);
+ADD_PRECISION_BENCHMARK(Full_Set_Double, "-0.5", "0.0", 3.0, max_max_iterations, Precision::double_precision);
+// where the UI starts
+ADD_RENDER_BENCHMARK(Default_Center, "0.001643721971153", "-0.822467633298876", Settings{}.scale, max_max_iterations);
+ADD_PAN_BENCHMARK(Default_Center, "0.001643721971153", "-0.822467633298876", Settings{}.scale, max_max_iterations);
+ADD_SHORTCUT_BENCHMARKS(Default_Center, "0.001643721971153", "-0.822467633298876", Settings{}.scale, max_max_iterations);
+// lots of slowly escaping points in between the bulbs
+ADD_RENDER_BENCHMARK(Seahorse_Valley, "-0.745", "0.11", 0.02, max_max_iterations);
+ADD_SHORTCUT_BENCHMARKS(Seahorse_Valley, "-0.745", "0.11", 0.02, max_max_iterations);
+ADD_PAN_BENCHMARK(Seahorse_Valley, "-0.745", "0.11", 0.02, max_max_iterations);
+ADD_PRECISION_BENCHMARK(Seahorse_Valley_Double, "-0.745", "0.11", 0.02, max_max_iterations, Precision::double_precision);
+// past where doubles can tell pixels apart, rendered in double-double
+ADD_RENDER_BENCHMARK(Deep_Zoom, "-0.743643887037151", "0.131825904205330", 1e-11, 10000);
+ADD_PRECISION_BENCHMARK(Deep_Zoom_Perturbation, "-0.743643887037151", "0.131825904205330", 1e-11, 10000, Precision::perturbation);
+// right next to the Misiurewicz point i, where there is still detail at any depth, by perturbation
+ADD_RENDER_BENCHMARK(Deep_Zoom_1e100,
+                     "-0.00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000001234567890123456789012345",
+                     "1.00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000005678901234567890123456789",
+                     1e-100,
+                     max_max_iterations);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,156 @@
+#include "mandelbrot.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+constexpr static Size size{ 640u, 640u };
+
+// binary PPM, 8 bits per channel
+template<std::size_t Width, std::size_t Height> void write_ppm(std::ostream &os, const Image<Width, Height> &img)
+{
+  os << "P6\n" << Width << ' ' << Height << "\n255\n";
+  for (const auto &color : img.colors) {
+    const std::array<char, 3> rgb{ static_cast<char>(color.r), static_cast<char>(color.g), static_cast<char>(color.b) };
+    os.write(rgb.data(), rgb.size());
+  }
+}
+
+// milliseconds per tile, laid out like the image, to make load imbalance visible
+template<std::size_t Width, std::size_t Height> void print_tile_stats(const ProgressiveRenderer<Width, Height> &renderer)
+{
+  using Renderer = ProgressiveRenderer<Width, Height>;
+
+  const auto &stats = renderer.tile_stats();
+  std::chrono::duration<double, std::milli> total{};
+  std::chrono::duration<double, std::milli> slowest{};
+  for (const auto &tile : stats) {
+    total += tile.time;
+    slowest = std::max<std::chrono::duration<double, std::milli>>(slowest, tile.time);
+  }
+
+  std::cout << "Tile times in ms (" << Renderer::tile_size << 'x' << Renderer::tile_size << " tiles):\n" << std::fixed << std::setprecision(1);
+  for (std::size_t tile_y = 0; tile_y < Renderer::tiles_y; ++tile_y) {
+    for (std::size_t tile_x = 0; tile_x < Renderer::tiles_x; ++tile_x) {
+      std::cout << std::setw(7) << std::chrono::duration<double, std::milli>{ stats[tile_y * Renderer::tiles_x + tile_x].time }.count();
+    }
+    std::cout << '\n';
+  }
+  std::cout << "Total " << total.count() << "ms, slowest tile " << slowest.count() << "ms, mean " << total.count() / static_cast<double>(stats.size()) << "ms\n"
+            << std::defaultfloat;
+}
+
+constexpr std::array<std::pair<std::string_view, Precision>, 5> precision_names{ { { "auto", Precision::automatic },
+                                                                                    { "single", Precision::single },
+                                                                                    { "double", Precision::double_precision },
+                                                                                    { "double-double", Precision::double_double },
+                                                                                    { "perturbation", Precision::perturbation } } };
+
+Precision parse_precision(const std::string_view name)
+{
+  for (const auto &[precision_name, precision] : precision_names) {
+    if (precision_name == name) { return precision; }
+  }
+  throw std::invalid_argument("unknown precision: " + std::string{ name });
+}
+
+std::string_view precision_name(const Precision precision)
+{
+  for (const auto &[name, value] : precision_names) {
+    if (value == precision) { return name; }
+  }
+  return "?";
+}
+
+void print_usage(const char *name)
+{
+  std::cerr << "Usage: " << name << " [--center <x> <y>] [--scale <scale>] [--iterations <count>] [--power <power>] [--abs] [--threads <count>] [--tile-stats] [--output <file.ppm>]\n"
+            << "       [--no-interior-checks] [--no-periodicity] [--no-mariani-silver] [--precision auto|single|double|double-double|perturbation]\n"
+            << "Renders a " << size.width << 'x' << size.height << " image without opening a window\n";
+}
+
+int main(int argc, char *argv[])
+{
+  Settings settings{};
+  std::size_t max_iteration = max_max_iterations;
+  std::string output        = "mandelbrot.ppm";
+  std::size_t threads       = std::max(1u, std::thread::hardware_concurrency());
+  bool tile_stats           = false;
+
+  try {
+    for (int arg = 1; arg < argc; ++arg) {
+      const std::string_view option{ argv[arg] };
+      const auto value = [&]() -> std::string {
+        if (arg + 1 >= argc) { throw std::invalid_argument("missing value for " + std::string{ option }); }
+        return argv[++arg];
+      };
+
+      if (option == "--center") {
+        // as many digits as a deep zoom needs
+        settings.center.x = Coordinate::from_string(value());
+        settings.center.y = Coordinate::from_string(value());
+      } else if (option == "--scale") {
+        settings.scale = std::stod(value());
+      } else if (option == "--iterations") {
+        max_iteration = std::stoul(value());
+      } else if (option == "--power") {
+        settings.power = std::stod(value());
+      } else if (option == "--abs") {
+        settings.do_abs = true;
+      } else if (option == "--threads") {
+        threads = std::stoul(value());
+      } else if (option == "--no-interior-checks") {
+        settings.shortcuts.interior_checks = false;
+      } else if (option == "--no-periodicity") {
+        settings.shortcuts.periodicity = false;
+      } else if (option == "--no-mariani-silver") {
+        settings.shortcuts.mariani_silver = false;
+      } else if (option == "--precision") {
+        settings.precision = parse_precision(value());
+      } else if (option == "--tile-stats") {
+        tile_stats = true;
+      } else if (option == "--output") {
+        output = value();
+      } else {
+        print_usage(argv[0]);
+        return 1;
+      }
+    }
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " << e.what() << '\n';
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  const auto img      = std::make_unique<Image<size.width, size.height>>();
+  const auto renderer = std::make_unique<ProgressiveRenderer<size.width, size.height>>(false, threads);
+  SingleFrame<size.width, size.height> frame{ *img };
+
+  const auto start = std::chrono::steady_clock::now();
+  renderer->render(frame, settings, max_iteration, CancellationToken{});
+  const auto seconds = std::chrono::duration<double>{ std::chrono::steady_clock::now() - start }.count();
+
+  std::cout << "Rendered " << size.width << 'x' << size.height << " with " << max_iteration << " max iterations in " << precision_name(renderer->precision())
+            << " precision in " << seconds << "s ("
+            << static_cast<double>(size.width * size.height) / seconds / 1e6 << " Mpixels/s)\n";
+  // the deeper tiers only have kernels for some powers, past those pixels blur together
+  if (!resolves_view(settings, size, renderer->precision())) {
+    std::cout << "Warning: " << precision_name(renderer->precision()) << " precision is too coarse for this scale, ";
+    if (settings.precision == renderer->precision()) {
+      std::cout << "but it was asked for\n";
+    } else {
+      std::cout << "there is no deeper kernel for power " << settings.power << (settings.do_abs ? " with --abs" : "") << '\n';
+    }
+  }
+
+  if (tile_stats) { print_tile_stats(*renderer); }
+
+  std::ofstream file{ output, std::ios::binary };
+  write_ppm(file, *img);
+  if (!file) {
+    std::cerr << "Error: could not write " << output << '\n';
+    return 1;
+  }
+}